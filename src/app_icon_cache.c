@@ -0,0 +1,269 @@
+#include "app_icon_cache.h"
+#include "desktop_index_monitor.h"
+#include <string.h>
+
+#define FALLBACK_ICON "application-x-executable"
+
+typedef struct {
+    const gchar *desktop_file;  // apunta al índice
+    GIcon *icon;                // NULL si la entrada no tiene Icon=
+} AppEntry;
+
+struct _AppIconCache {
+    GObject parent_instance;
+
+    // Índice compartido con el menú; las tablas se hacen en la primera
+    // consulta tras cada índice nuevo
+    DesktopIndexMonitor *index_monitor;
+    gulong index_monitor_handler;
+    DesktopIndex *index;
+
+    // id sin ".desktop" → AppEntry (de `owned`); NULL hasta la primera consulta
+    GHashTable *ids;
+    // Otros nombres (minúsculas, sin org./com., StartupWMClass) → AppEntry.
+    // Solo se consulta si el id no existe, así un alias nunca tapa un id
+    GHashTable *aliases;
+    GPtrArray *owned;
+
+    // Consultas sin entrada: app_id → GIcon temático con respaldo
+    GHashTable *fallbacks;
+};
+
+enum {
+    SIGNAL_CHANGED,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+G_DEFINE_TYPE(AppIconCache, app_icon_cache, G_TYPE_OBJECT)
+
+static void app_entry_free(gpointer data) {
+    AppEntry *entry = data;
+
+    if (entry->icon) g_object_unref(entry->icon);
+    g_free(entry);
+}
+
+static GIcon *icon_from_name(const gchar *name) {
+    if (g_path_is_absolute(name)) {
+        GFile *file = g_file_new_for_path(name);
+        GIcon *icon = g_file_icon_new(file);
+        g_object_unref(file);
+        return icon;
+    }
+
+    const gchar *names[] = { name, FALLBACK_ICON };
+    return g_themed_icon_new_from_names((gchar **)names, G_N_ELEMENTS(names));
+}
+
+// El índice guarda g_icon_to_string(): nombre temático, ruta o GIcon serializado
+static GIcon *icon_from_index(const gchar *icon_str) {
+    GIcon *icon = g_icon_new_for_string(icon_str, NULL);
+
+    if (icon && G_IS_THEMED_ICON(icon)) {
+        g_themed_icon_append_name(G_THEMED_ICON(icon), FALLBACK_ICON);
+    }
+
+    return icon;
+}
+
+// "kde4-foo.desktop" → "kde4-foo", como lo anuncian las ventanas
+static gchar *strip_desktop_suffix(const gchar *desktop_id) {
+    gsize len = strlen(desktop_id);
+
+    if (g_str_has_suffix(desktop_id, ".desktop")) {
+        len -= strlen(".desktop");
+    }
+    return g_strndup(desktop_id, len);
+}
+
+// Entre alias del mismo nivel gana la primera entrada del índice
+static void add_alias(AppIconCache *self, const gchar *key, AppEntry *entry) {
+    if (!*key || g_hash_table_contains(self->aliases, key)) return;
+    g_hash_table_insert(self->aliases, g_strdup(key), entry);
+}
+
+static void add_aliases(AppIconCache *self, const gchar *key, AppEntry *entry) {
+    gchar *lower = g_ascii_strdown(key, -1);
+
+    add_alias(self, key, entry);
+    add_alias(self, lower, entry);
+
+    // Los antiguos org.foo / com.foo también responden a "foo"
+    if (g_str_has_prefix(lower, "org.") || g_str_has_prefix(lower, "com.")) {
+        add_alias(self, lower + 4, entry);
+    }
+
+    g_free(lower);
+}
+
+static gboolean build_tables(AppIconCache *self) {
+    DesktopIndex *index = desktop_index_monitor_get_index(self->index_monitor);
+
+    // El primer índice aún se está construyendo: llegará con "changed"
+    if (!index) return FALSE;
+
+    gint64 start = g_get_monotonic_time();
+    guint n_entries = desktop_index_get_n_entries(index);
+
+    self->index = desktop_index_ref(index);
+    self->ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    self->aliases = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    self->owned = g_ptr_array_new_full(n_entries, app_entry_free);
+
+    // Primero todos los ids, que son únicos
+    for (guint i = 0; i < n_entries; i++) {
+        DesktopIndexEntry index_entry;
+        desktop_index_get_entry(index, i, &index_entry);
+
+        AppEntry *entry = g_new0(AppEntry, 1);
+        entry->desktop_file = index_entry.filename;
+        if (*index_entry.icon) {
+            entry->icon = icon_from_index(index_entry.icon);
+        }
+        g_ptr_array_add(self->owned, entry);
+
+        gchar *id = strip_desktop_suffix(index_entry.id);
+        g_hash_table_insert(self->ids, id, entry);
+    }
+
+    // Después los alias: los derivados del id de cualquier entrada van antes
+    // que los StartupWMClass, que son más propensos a repetirse
+    for (guint i = 0; i < n_entries; i++) {
+        DesktopIndexEntry index_entry;
+        desktop_index_get_entry(index, i, &index_entry);
+
+        gchar *id = strip_desktop_suffix(index_entry.id);
+        add_aliases(self, id, g_ptr_array_index(self->owned, i));
+        g_free(id);
+    }
+
+    for (guint i = 0; i < n_entries; i++) {
+        DesktopIndexEntry index_entry;
+        desktop_index_get_entry(index, i, &index_entry);
+
+        add_aliases(self, index_entry.wm_class, g_ptr_array_index(self->owned, i));
+    }
+
+    g_debug("Índice de iconos: %u entradas .desktop en %.1f ms", n_entries,
+            (g_get_monotonic_time() - start) / 1000.0);
+    return TRUE;
+}
+
+static void drop_tables(AppIconCache *self) {
+    g_clear_pointer(&self->ids, g_hash_table_destroy);
+    g_clear_pointer(&self->aliases, g_hash_table_destroy);
+    g_clear_pointer(&self->owned, g_ptr_array_unref);
+    g_hash_table_remove_all(self->fallbacks);
+
+    if (self->index) {
+        desktop_index_unref(self->index);
+        self->index = NULL;
+    }
+}
+
+// Hay un índice nuevo: las tablas se rehacen en la siguiente consulta, que
+// llegará desde "changed"
+static void on_index_changed(DesktopIndexMonitor *monitor G_GNUC_UNUSED, DesktopIndex *previous G_GNUC_UNUSED,
+                             DesktopIndexDiff *diff G_GNUC_UNUSED, gpointer user_data) {
+    AppIconCache *self = APP_ICON_CACHE(user_data);
+
+    drop_tables(self);
+    g_signal_emit(self, signals[SIGNAL_CHANGED], 0);
+}
+
+static AppEntry *lookup_entry(AppIconCache *self, const gchar *app_id) {
+    if (!app_id || !*app_id) return NULL;
+
+    if (!self->ids && !build_tables(self)) {
+        return NULL;
+    }
+
+    AppEntry *entry = g_hash_table_lookup(self->ids, app_id);
+    if (!entry) {
+        entry = g_hash_table_lookup(self->aliases, app_id);
+    }
+    if (!entry) {
+        gchar *lower = g_ascii_strdown(app_id, -1);
+        entry = g_hash_table_lookup(self->aliases, lower);
+        g_free(lower);
+    }
+
+    return entry;
+}
+
+GIcon *app_icon_cache_lookup_icon(AppIconCache *self, const gchar *app_id) {
+    g_return_val_if_fail(APP_IS_ICON_CACHE(self), NULL);
+
+    AppEntry *entry = lookup_entry(self, app_id);
+    if (entry && entry->icon) return entry->icon;
+
+    // Muchas apps usan su app_id como nombre de icono
+    const gchar *key = app_id ? app_id : "";
+    GIcon *icon = g_hash_table_lookup(self->fallbacks, key);
+    if (!icon) {
+        icon = *key ? icon_from_name(key) : g_themed_icon_new(FALLBACK_ICON);
+        g_hash_table_insert(self->fallbacks, g_strdup(key), icon);
+    }
+
+    return icon;
+}
+
+const gchar *app_icon_cache_lookup_desktop_file(AppIconCache *self, const gchar *app_id) {
+    g_return_val_if_fail(APP_IS_ICON_CACHE(self), NULL);
+
+    AppEntry *entry = lookup_entry(self, app_id);
+    return entry && *entry->desktop_file ? entry->desktop_file : NULL;
+}
+
+static void app_icon_cache_dispose(GObject *object) {
+    AppIconCache *self = APP_ICON_CACHE(object);
+
+    if (self->index_monitor) {
+        g_signal_handler_disconnect(self->index_monitor, self->index_monitor_handler);
+        g_clear_object(&self->index_monitor);
+    }
+
+    G_OBJECT_CLASS(app_icon_cache_parent_class)->dispose(object);
+}
+
+static void app_icon_cache_finalize(GObject *object) {
+    AppIconCache *self = APP_ICON_CACHE(object);
+
+    drop_tables(self);
+    g_hash_table_destroy(self->fallbacks);
+
+    G_OBJECT_CLASS(app_icon_cache_parent_class)->finalize(object);
+}
+
+static void app_icon_cache_init(AppIconCache *self) {
+    self->fallbacks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+
+    self->index_monitor = g_object_ref(desktop_index_monitor_get_default());
+    self->index_monitor_handler = g_signal_connect(self->index_monitor, "changed",
+                                                   G_CALLBACK(on_index_changed), self);
+}
+
+static void app_icon_cache_class_init(AppIconCacheClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = app_icon_cache_dispose;
+    object_class->finalize = app_icon_cache_finalize;
+
+    // Hay un índice de aplicaciones nuevo: volver a pedir los iconos
+    signals[SIGNAL_CHANGED] = g_signal_new("changed",
+                                           G_TYPE_FROM_CLASS(klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 0);
+}
+
+AppIconCache *app_icon_cache_get_default(void) {
+    static AppIconCache *default_cache = NULL;
+
+    if (!default_cache) {
+        default_cache = g_object_new(APP_TYPE_ICON_CACHE, NULL);
+    }
+
+    return default_cache;
+}
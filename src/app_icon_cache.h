@@ -0,0 +1,26 @@
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+// Índice de proceso app-id → entrada .desktop e icono, compartido por la
+// lista de tareas, los lanzadores y la bandeja. Sus tablas salen del
+// DesktopIndex del menú en la primera consulta y se descartan con cada índice
+// nuevo; las consultas nunca tocan el sistema de archivos. Hasta que existe
+// el primer índice todo se resuelve como nombre de icono.
+#define APP_TYPE_ICON_CACHE (app_icon_cache_get_type())
+G_DECLARE_FINAL_TYPE(AppIconCache, app_icon_cache, APP, ICON_CACHE, GObject)
+
+AppIconCache *app_icon_cache_get_default(void);
+
+// Icono para un app_id (Wayland), id de .desktop, StartupWMClass o nombre de
+// icono, en ese orden: un id exacto siempre gana a un alias. Nunca NULL: lo
+// desconocido se prueba como nombre de icono con application-x-executable de
+// respaldo. Propiedad de la caché
+GIcon *app_icon_cache_lookup_icon(AppIconCache *self, const gchar *app_id);
+
+// Ruta del .desktop o NULL. Ambos son válidos hasta la siguiente emisión de "changed"
+const gchar *app_icon_cache_lookup_desktop_file(AppIconCache *self, const gchar *app_id);
+
+G_END_DECLS
@@ -17,15 +17,31 @@ PanelConfig *panel_config_new(void) {
     config->clock_size = 0;
     config->clock_weight = NULL;
     config->clock_color = NULL;
+    config->clock_format = NULL;
     
     config->showdesktop_enable = TRUE;
     
+    // 0 es un valor válido (sin límite): el defecto se pone aquí y no en apply_default_values
+    config->tasklist_background_title_rate = 2;
+    
     config->systray_enable = FALSE;
     config->systray_icon_size = 0;
 
     config->ram_monitor_enable = TRUE;
     config->cpu_monitor_enable = TRUE; 
+    config->cpu_monitor_mode = NULL;
+    config->cpu_monitor_scrolling = FALSE;
     config->net_monitor_enable = TRUE;
+    config->net_monitor_scrolling = FALSE;
+    config->net_monitor_include = NULL;
+    config->net_monitor_exclude = NULL;
+    config->net_monitor_backend = NULL;
+    config->disk_monitor_enable = TRUE;
+    config->disk_monitor_scrolling = FALSE;
+    config->disk_monitor_include = NULL;
+    config->disk_monitor_exclude = NULL;
+    config->disk_monitor_partitions = FALSE;
+    config->sensors_enable = TRUE;
 
     return config;
 }
@@ -43,6 +59,13 @@ void panel_config_free(PanelConfig *config) {
     g_free(config->menu_icon);
     g_free(config->clock_weight);
     g_free(config->clock_color);
+    g_free(config->clock_format);
+    g_free(config->cpu_monitor_mode);
+    g_free(config->net_monitor_include);
+    g_free(config->net_monitor_exclude);
+    g_free(config->net_monitor_backend);
+    g_free(config->disk_monitor_include);
+    g_free(config->disk_monitor_exclude);
     g_free(config);
 }
 
@@ -78,6 +101,51 @@ static void apply_default_values(PanelConfig *config) {
     if (config->clock_size <= 0) config->clock_size = 13;
     if (!config->clock_weight) config->clock_weight = g_strdup("normal");
     if (!config->clock_color) config->clock_color = g_strdup("white");
+    if (!config->clock_format) config->clock_format = g_strdup("%H:%M");
+    
+    config->tasklist_background_title_rate = MAX(config->tasklist_background_title_rate, 0);
+    
+    if (!config->cpu_monitor_mode) config->cpu_monitor_mode = g_strdup("total");
+    
+    // Por defecto no contar loopback, puentes de contenedores ni túneles VPN,
+    // cuyo tráfico ya pasa por la interfaz física
+    if (!config->net_monitor_include) config->net_monitor_include = g_strdup("");
+    if (!config->net_monitor_exclude) {
+        config->net_monitor_exclude = g_strdup("lo,docker*,br-*,veth*,virbr*,tun*,tap*,wg*");
+    }
+    if (!config->net_monitor_backend) config->net_monitor_backend = g_strdup("proc");
+    
+    // Por defecto no contar dispositivos virtuales: loop y zram no son discos, y
+    // dm/md repetirían la E/S que ya cuentan los discos que tienen debajo
+    if (!config->disk_monitor_include) config->disk_monitor_include = g_strdup("");
+    if (!config->disk_monitor_exclude) {
+        config->disk_monitor_exclude = g_strdup("loop*,ram*,zram*,dm-*,md*,sr*,fd*");
+    }
+    
+    // Historial entre 2 muestras y un día a 1 Hz; intervalo mínimo de 100 ms
+    if (config->cpu_monitor_history <= 0) config->cpu_monitor_history = 30;
+    if (config->ram_monitor_history <= 0) config->ram_monitor_history = 30;
+    if (config->net_monitor_history <= 0) config->net_monitor_history = 30;
+    if (config->disk_monitor_history <= 0) config->disk_monitor_history = 30;
+    config->cpu_monitor_history = CLAMP(config->cpu_monitor_history, 2, 86400);
+    config->ram_monitor_history = CLAMP(config->ram_monitor_history, 2, 86400);
+    config->net_monitor_history = CLAMP(config->net_monitor_history, 2, 86400);
+    config->disk_monitor_history = CLAMP(config->disk_monitor_history, 2, 86400);
+    
+    if (config->cpu_monitor_interval_ms <= 0) config->cpu_monitor_interval_ms = 1000;
+    if (config->ram_monitor_interval_ms <= 0) config->ram_monitor_interval_ms = 2000;
+    if (config->net_monitor_interval_ms <= 0) config->net_monitor_interval_ms = 1000;
+    if (config->disk_monitor_interval_ms <= 0) config->disk_monitor_interval_ms = 1000;
+    config->cpu_monitor_interval_ms = MAX(config->cpu_monitor_interval_ms, 100);
+    config->ram_monitor_interval_ms = MAX(config->ram_monitor_interval_ms, 100);
+    config->net_monitor_interval_ms = MAX(config->net_monitor_interval_ms, 100);
+    config->disk_monitor_interval_ms = MAX(config->disk_monitor_interval_ms, 100);
+    
+    // Temperatura y batería cambian despacio; algunos sensores ACPI tardan en leerse
+    if (config->sensors_interval_ms <= 0) config->sensors_interval_ms = 2000;
+    config->sensors_interval_ms = MAX(config->sensors_interval_ms, 100);
+    if (config->sensors_warning_temp <= 0) config->sensors_warning_temp = 80;
+    if (config->sensors_battery_low <= 0) config->sensors_battery_low = 15;
 }
 
 // Cargar configuración desde archivo INI
@@ -127,6 +195,7 @@ gboolean panel_config_load(PanelConfig *config, const gchar *config_path) {
         load_int_key(key_file, "clock", "size", &config->clock_size);
         load_string_key(key_file, "clock", "weight", &config->clock_weight);
         load_string_key(key_file, "clock", "color", &config->clock_color);
+        load_string_key(key_file, "clock", "format", &config->clock_format);
     }
     
     // Cargar configuración del show desktop
@@ -134,15 +203,47 @@ gboolean panel_config_load(PanelConfig *config, const gchar *config_path) {
         load_bool_key(key_file, "showdesktop", "enable", &config->showdesktop_enable);
     }
     
+    // Cargar configuración de la lista de tareas
+    if (g_key_file_has_group(key_file, "tasklist")) {
+        load_int_key(key_file, "tasklist", "background_title_rate", &config->tasklist_background_title_rate);
+    }
+    
     // System Monitor widgets
     if (g_key_file_has_group(key_file, "ram_monitor")) {
         load_bool_key(key_file, "ram_monitor", "enable", &config->ram_monitor_enable);
+        load_int_key(key_file, "ram_monitor", "history", &config->ram_monitor_history);
+        load_int_key(key_file, "ram_monitor", "interval_ms", &config->ram_monitor_interval_ms);
     }
     if (g_key_file_has_group(key_file, "cpu_monitor")) {
         load_bool_key(key_file, "cpu_monitor", "enable", &config->cpu_monitor_enable);
+        load_string_key(key_file, "cpu_monitor", "mode", &config->cpu_monitor_mode);
+        load_bool_key(key_file, "cpu_monitor", "scrolling", &config->cpu_monitor_scrolling);
+        load_int_key(key_file, "cpu_monitor", "history", &config->cpu_monitor_history);
+        load_int_key(key_file, "cpu_monitor", "interval_ms", &config->cpu_monitor_interval_ms);
     }
     if (g_key_file_has_group(key_file, "net_monitor")) {
         load_bool_key(key_file, "net_monitor", "enable", &config->net_monitor_enable);
+        load_bool_key(key_file, "net_monitor", "scrolling", &config->net_monitor_scrolling);
+        load_int_key(key_file, "net_monitor", "history", &config->net_monitor_history);
+        load_int_key(key_file, "net_monitor", "interval_ms", &config->net_monitor_interval_ms);
+        load_string_key(key_file, "net_monitor", "include", &config->net_monitor_include);
+        load_string_key(key_file, "net_monitor", "exclude", &config->net_monitor_exclude);
+        load_string_key(key_file, "net_monitor", "backend", &config->net_monitor_backend);
+    }
+    if (g_key_file_has_group(key_file, "disk_monitor")) {
+        load_bool_key(key_file, "disk_monitor", "enable", &config->disk_monitor_enable);
+        load_bool_key(key_file, "disk_monitor", "scrolling", &config->disk_monitor_scrolling);
+        load_int_key(key_file, "disk_monitor", "history", &config->disk_monitor_history);
+        load_int_key(key_file, "disk_monitor", "interval_ms", &config->disk_monitor_interval_ms);
+        load_string_key(key_file, "disk_monitor", "include", &config->disk_monitor_include);
+        load_string_key(key_file, "disk_monitor", "exclude", &config->disk_monitor_exclude);
+        load_bool_key(key_file, "disk_monitor", "partitions", &config->disk_monitor_partitions);
+    }
+    if (g_key_file_has_group(key_file, "sensors")) {
+        load_bool_key(key_file, "sensors", "enable", &config->sensors_enable);
+        load_int_key(key_file, "sensors", "interval_ms", &config->sensors_interval_ms);
+        load_int_key(key_file, "sensors", "warning_temp", &config->sensors_warning_temp);
+        load_int_key(key_file, "sensors", "battery_low", &config->sensors_battery_low);
     }
     
     // Aplicar valores por defecto para cualquier clave que falte
@@ -184,14 +285,39 @@ gboolean panel_config_save(PanelConfig *config, const gchar *config_path) {
     g_key_file_set_integer(key_file, "clock", "size", config->clock_size);
     g_key_file_set_string(key_file, "clock", "weight", config->clock_weight);
     g_key_file_set_string(key_file, "clock", "color", config->clock_color);
+    g_key_file_set_string(key_file, "clock", "format", config->clock_format);
     
     // Configuración del show desktop
     g_key_file_set_boolean(key_file, "showdesktop", "enable", config->showdesktop_enable);
+    g_key_file_set_integer(key_file, "tasklist", "background_title_rate", config->tasklist_background_title_rate);
     
     // System Monitor widgets
     g_key_file_set_boolean(key_file, "ram_monitor", "enable", config->ram_monitor_enable);
+    g_key_file_set_integer(key_file, "ram_monitor", "history", config->ram_monitor_history);
+    g_key_file_set_integer(key_file, "ram_monitor", "interval_ms", config->ram_monitor_interval_ms);
     g_key_file_set_boolean(key_file, "cpu_monitor", "enable", config->cpu_monitor_enable);
+    g_key_file_set_string(key_file, "cpu_monitor", "mode", config->cpu_monitor_mode);
+    g_key_file_set_boolean(key_file, "cpu_monitor", "scrolling", config->cpu_monitor_scrolling);
+    g_key_file_set_integer(key_file, "cpu_monitor", "history", config->cpu_monitor_history);
+    g_key_file_set_integer(key_file, "cpu_monitor", "interval_ms", config->cpu_monitor_interval_ms);
     g_key_file_set_boolean(key_file, "net_monitor", "enable", config->net_monitor_enable);
+    g_key_file_set_boolean(key_file, "net_monitor", "scrolling", config->net_monitor_scrolling);
+    g_key_file_set_integer(key_file, "net_monitor", "history", config->net_monitor_history);
+    g_key_file_set_integer(key_file, "net_monitor", "interval_ms", config->net_monitor_interval_ms);
+    g_key_file_set_string(key_file, "net_monitor", "include", config->net_monitor_include);
+    g_key_file_set_string(key_file, "net_monitor", "exclude", config->net_monitor_exclude);
+    g_key_file_set_string(key_file, "net_monitor", "backend", config->net_monitor_backend);
+    g_key_file_set_boolean(key_file, "disk_monitor", "enable", config->disk_monitor_enable);
+    g_key_file_set_boolean(key_file, "disk_monitor", "scrolling", config->disk_monitor_scrolling);
+    g_key_file_set_integer(key_file, "disk_monitor", "history", config->disk_monitor_history);
+    g_key_file_set_integer(key_file, "disk_monitor", "interval_ms", config->disk_monitor_interval_ms);
+    g_key_file_set_string(key_file, "disk_monitor", "include", config->disk_monitor_include);
+    g_key_file_set_string(key_file, "disk_monitor", "exclude", config->disk_monitor_exclude);
+    g_key_file_set_boolean(key_file, "disk_monitor", "partitions", config->disk_monitor_partitions);
+    g_key_file_set_boolean(key_file, "sensors", "enable", config->sensors_enable);
+    g_key_file_set_integer(key_file, "sensors", "interval_ms", config->sensors_interval_ms);
+    g_key_file_set_integer(key_file, "sensors", "warning_temp", config->sensors_warning_temp);
+    g_key_file_set_integer(key_file, "sensors", "battery_low", config->sensors_battery_low);
     
     // Crear directorio padre si no existe
     gchar *dir = g_path_get_dirname(config_path);
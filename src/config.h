@@ -31,14 +31,42 @@ typedef struct _PanelConfig {
     gint clock_size;
     gchar *clock_weight;
     gchar *clock_color;
+    gchar *clock_format;
     
     // Show Desktop settings
     gboolean showdesktop_enable;
     
+    // Tasklist settings
+    gint tasklist_background_title_rate; // títulos/s de ventanas en segundo plano; 0 = sin límite
+    
     // System Monitor widgets
+    // history: número de muestras guardadas; interval_ms: periodo de muestreo
     gboolean ram_monitor_enable;
+    gint ram_monitor_history;
+    gint ram_monitor_interval_ms;
     gboolean cpu_monitor_enable;
+    gchar *cpu_monitor_mode;
+    gboolean cpu_monitor_scrolling;
+    gint cpu_monitor_history;
+    gint cpu_monitor_interval_ms;
     gboolean net_monitor_enable;
+    gboolean net_monitor_scrolling;
+    gint net_monitor_history;
+    gint net_monitor_interval_ms;
+    gchar *net_monitor_include;     // globs separados por comas; vacío = todas
+    gchar *net_monitor_exclude;
+    gchar *net_monitor_backend;     // "proc" o "netlink"
+    gboolean disk_monitor_enable;
+    gboolean disk_monitor_scrolling;
+    gint disk_monitor_history;
+    gint disk_monitor_interval_ms;
+    gchar *disk_monitor_include;    // globs separados por comas; vacío = todos
+    gchar *disk_monitor_exclude;
+    gboolean disk_monitor_partitions; // contar también las particiones
+    gboolean sensors_enable;
+    gint sensors_interval_ms;
+    gint sensors_warning_temp;      // °C a partir de los que se marca en rojo
+    gint sensors_battery_low;       // % de batería por debajo del cual se avisa
 } PanelConfig;
 
 // Functions
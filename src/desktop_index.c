@@ -0,0 +1,510 @@
+#include "desktop_index.h"
+#include <gio/gdesktopappinfo.h>
+#include <errno.h>
+#include <string.h>
+
+#define INDEX_MAGIC "SPDI"
+#define INDEX_VERSION 2
+
+// Hasta dónde se siguen los subdirectorios de applications (kde4/, wine/...)
+#define MAX_DIR_DEPTH 4
+
+// Formato del archivo, en el orden de bytes de la máquina (es una caché local):
+// cabecera | IndexDir[n_dirs] | IndexEntry[n_entries] | tabla de cadenas.
+// Las cadenas se guardan como desplazamientos en la tabla, que empieza por "\0"
+typedef struct {
+    gchar magic[4];
+    guint32 version;
+    guint32 environment;    // idioma, escritorio y directorios con que se construyó
+    guint32 n_dirs;
+    guint32 n_entries;
+    guint32 strings_size;
+} IndexHeader;
+
+typedef struct {
+    guint32 path;
+    guint32 padding;
+    gint64 mtime;           // µs; -1 si no existía
+} IndexDir;
+
+enum {
+    INDEX_ENTRY_SHOW = 1 << 0,  // g_app_info_should_show(): va en el menú
+};
+
+typedef struct {
+    guint32 id;
+    guint32 name;
+    guint32 icon;
+    guint32 categories;
+    guint32 exec;
+    guint32 wm_class;
+    guint32 filename;
+    guint32 flags;
+} IndexEntry;
+
+G_STATIC_ASSERT(sizeof(IndexHeader) % 8 == 0);
+G_STATIC_ASSERT(sizeof(IndexDir) == 16);
+G_STATIC_ASSERT(sizeof(IndexEntry) == 8 * sizeof(guint32));
+
+struct _DesktopIndex {
+    gatomicrefcount ref_count;  // se comparte con el hilo que calcula el diff
+    GBytes *bytes;          // el mmap del archivo o el búfer recién construido
+    const IndexHeader *header;
+    const IndexDir *dirs;
+    const IndexEntry *entries;
+    const gchar *strings;
+};
+
+typedef struct {
+    GString *strings;
+    GHashTable *offsets;    // cadena → desplazamiento: las categorías se repiten mucho
+    GArray *dirs;
+    GArray *entries;
+} IndexBuilder;
+
+static gchar *index_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "simple-panel", "desktop-index", NULL);
+}
+
+// Directorios applications en orden de precedencia de XDG
+static GPtrArray *application_dirs(void) {
+    GPtrArray *dirs = g_ptr_array_new_with_free_func(g_free);
+
+    g_ptr_array_add(dirs, g_build_filename(g_get_user_data_dir(), "applications", NULL));
+    for (const gchar * const *data_dirs = g_get_system_data_dirs(); *data_dirs; data_dirs++) {
+        g_ptr_array_add(dirs, g_build_filename(*data_dirs, "applications", NULL));
+    }
+
+    return dirs;
+}
+
+// Lo que cambia el contenido del índice sin tocar ningún mtime
+static gchar *index_environment(GPtrArray *dirs) {
+    const gchar *desktop = g_getenv("XDG_CURRENT_DESKTOP");
+    gchar *languages = g_strjoinv(":", (gchar **)g_get_language_names());
+    GString *environment = g_string_new(NULL);
+
+    g_string_append_printf(environment, "%s\n%s\n", languages, desktop ? desktop : "");
+    for (guint i = 0; i < dirs->len; i++) {
+        g_string_append_printf(environment, "%s:", (const gchar *)g_ptr_array_index(dirs, i));
+    }
+
+    g_free(languages);
+    return g_string_free(environment, FALSE);
+}
+
+// mtime en µs, o -1 si no es un directorio
+static gint64 directory_mtime(const gchar *path) {
+    GFile *file = g_file_new_for_path(path);
+    GFileInfo *info = g_file_query_info(file,
+                                        G_FILE_ATTRIBUTE_STANDARD_TYPE ","
+                                        G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                                        G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                                        G_FILE_QUERY_INFO_NONE, NULL, NULL);
+    gint64 mtime = -1;
+
+    if (info && g_file_info_get_file_type(info) == G_FILE_TYPE_DIRECTORY) {
+        mtime = g_file_info_get_attribute_uint64(info, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+                g_file_info_get_attribute_uint32(info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+    }
+
+    g_clear_object(&info);
+    g_object_unref(file);
+    return mtime;
+}
+
+static guint32 builder_add_string(IndexBuilder *builder, const gchar *str) {
+    gpointer offset;
+
+    if (!str || !*str) return 0;
+
+    if (g_hash_table_lookup_extended(builder->offsets, str, NULL, &offset)) {
+        return GPOINTER_TO_UINT(offset);
+    }
+
+    guint32 result = builder->strings->len;
+    g_string_append_len(builder->strings, str, strlen(str) + 1);
+    g_hash_table_insert(builder->offsets, g_strdup(str), GUINT_TO_POINTER(result));
+    return result;
+}
+
+// Un .desktop nuevo, borrado o renombrado cambia el mtime de su directorio;
+// los directorios que no existen también se guardan por si aparecen
+static void builder_add_dir(IndexBuilder *builder, const gchar *path, guint depth) {
+    IndexDir dir = { builder_add_string(builder, path), 0, directory_mtime(path) };
+    const gchar *name;
+
+    g_array_append_val(builder->dirs, dir);
+    if (dir.mtime < 0 || depth >= MAX_DIR_DEPTH) return;
+
+    GDir *handle = g_dir_open(path, 0, NULL);
+    if (!handle) return;
+
+    while ((name = g_dir_read_name(handle))) {
+        if (g_str_has_suffix(name, ".desktop")) continue;
+
+        gchar *child = g_build_filename(path, name, NULL);
+        if (g_file_test(child, G_FILE_TEST_IS_DIR) && !g_file_test(child, G_FILE_TEST_IS_SYMLINK)) {
+            builder_add_dir(builder, child, depth + 1);
+        }
+        g_free(child);
+    }
+
+    g_dir_close(handle);
+}
+
+static void builder_add_app(IndexBuilder *builder, GDesktopAppInfo *desktop_info) {
+    GAppInfo *app_info = G_APP_INFO(desktop_info);
+    GIcon *icon = g_app_info_get_icon(app_info);
+    gchar *icon_str = icon ? g_icon_to_string(icon) : NULL;
+    IndexEntry entry = {
+        .id = builder_add_string(builder, g_app_info_get_id(app_info)),
+        .name = builder_add_string(builder, g_app_info_get_display_name(app_info)),
+        .icon = builder_add_string(builder, icon_str),
+        .categories = builder_add_string(builder, g_desktop_app_info_get_categories(desktop_info)),
+        .exec = builder_add_string(builder, g_app_info_get_commandline(app_info)),
+        .wm_class = builder_add_string(builder, g_desktop_app_info_get_startup_wm_class(desktop_info)),
+        .filename = builder_add_string(builder, g_desktop_app_info_get_filename(desktop_info)),
+        .flags = g_app_info_should_show(app_info) ? INDEX_ENTRY_SHOW : 0,
+    };
+
+    g_array_append_val(builder->entries, entry);
+    g_free(icon_str);
+}
+
+static GBytes *builder_serialize(IndexBuilder *builder, const gchar *environment) {
+    IndexHeader header = { .version = INDEX_VERSION };
+
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.environment = builder_add_string(builder, environment);
+    header.n_dirs = builder->dirs->len;
+    header.n_entries = builder->entries->len;
+    header.strings_size = builder->strings->len;
+
+    gsize dirs_size = builder->dirs->len * sizeof(IndexDir);
+    gsize entries_size = builder->entries->len * sizeof(IndexEntry);
+    gsize size = sizeof(header) + dirs_size + entries_size + builder->strings->len;
+    guint8 *data = g_malloc(size);
+    guint8 *p = data;
+
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    memcpy(p, builder->dirs->data, dirs_size);
+    p += dirs_size;
+    memcpy(p, builder->entries->data, entries_size);
+    p += entries_size;
+    memcpy(p, builder->strings->str, builder->strings->len);
+
+    return g_bytes_new_take(data, size);
+}
+
+// Comprobar la estructura entera: el archivo puede estar truncado o ser de otra versión
+static DesktopIndex *index_new_from_bytes(GBytes *bytes) {
+    gsize size;
+    const guint8 *data = g_bytes_get_data(bytes, &size);
+    const IndexHeader *header = (const IndexHeader *)data;
+
+    if (!data || size < sizeof(IndexHeader) ||
+        memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != INDEX_VERSION || header->strings_size == 0) {
+        return NULL;
+    }
+
+    guint64 expected = sizeof(IndexHeader) +
+                       (guint64)header->n_dirs * sizeof(IndexDir) +
+                       (guint64)header->n_entries * sizeof(IndexEntry) +
+                       header->strings_size;
+    if (expected != size || data[size - 1] != '\0') return NULL;
+
+    DesktopIndex *index = g_new0(DesktopIndex, 1);
+    g_atomic_ref_count_init(&index->ref_count);
+    index->header = header;
+    index->dirs = (const IndexDir *)(data + sizeof(IndexHeader));
+    index->entries = (const IndexEntry *)(index->dirs + header->n_dirs);
+    index->strings = (const gchar *)(index->entries + header->n_entries);
+
+    gboolean valid = header->environment < header->strings_size;
+    for (guint i = 0; valid && i < header->n_dirs; i++) {
+        valid = index->dirs[i].path < header->strings_size;
+    }
+    for (guint i = 0; valid && i < header->n_entries; i++) {
+        const IndexEntry *entry = &index->entries[i];
+        valid = entry->id < header->strings_size && entry->name < header->strings_size &&
+                entry->icon < header->strings_size && entry->categories < header->strings_size &&
+                entry->exec < header->strings_size && entry->wm_class < header->strings_size &&
+                entry->filename < header->strings_size;
+    }
+
+    if (!valid) {
+        g_free(index);
+        return NULL;
+    }
+
+    index->bytes = g_bytes_ref(bytes);
+    return index;
+}
+
+static gboolean index_is_stale(DesktopIndex *index) {
+    GPtrArray *dirs = application_dirs();
+    gchar *environment = index_environment(dirs);
+    gboolean stale = strcmp(environment, index->strings + index->header->environment) != 0;
+
+    for (guint i = 0; !stale && i < index->header->n_dirs; i++) {
+        stale = directory_mtime(index->strings + index->dirs[i].path) != index->dirs[i].mtime;
+    }
+
+    g_free(environment);
+    g_ptr_array_unref(dirs);
+    return stale;
+}
+
+DesktopIndex *desktop_index_load(gboolean *stale) {
+    gchar *path = index_path();
+    GError *error = NULL;
+    DesktopIndex *index = NULL;
+
+    *stale = TRUE;
+
+    GMappedFile *mapped = g_mapped_file_new(path, FALSE, &error);
+    if (mapped) {
+        GBytes *bytes = g_mapped_file_get_bytes(mapped);
+        index = index_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+        g_mapped_file_unref(mapped);
+
+        if (index) {
+            *stale = index_is_stale(index);
+        } else {
+            g_debug("Índice de aplicaciones no válido: %s", path);
+        }
+    } else {
+        if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            g_debug("No se pudo abrir el índice de aplicaciones: %s", error->message);
+        }
+        g_error_free(error);
+    }
+
+    g_free(path);
+    return index;
+}
+
+static void write_index(GBytes *bytes) {
+    gchar *path = index_path();
+    gchar *dir = g_path_get_dirname(path);
+    GError *error = NULL;
+    gsize size;
+    const gchar *data = g_bytes_get_data(bytes, &size);
+
+    // Escritura atómica: quien tenga mapeado el índice anterior lo sigue viendo entero
+    if (g_mkdir_with_parents(dir, 0700) != 0 ||
+        !g_file_set_contents(path, data, size, &error)) {
+        g_warning("No se pudo guardar el índice de aplicaciones en %s: %s", path,
+                  error ? error->message : g_strerror(errno));
+        g_clear_error(&error);
+    }
+
+    g_free(dir);
+    g_free(path);
+}
+
+static gboolean entries_equal(const DesktopIndexEntry *a, const DesktopIndexEntry *b) {
+    return strcmp(a->name, b->name) == 0 && strcmp(a->icon, b->icon) == 0 &&
+           strcmp(a->categories, b->categories) == 0 && strcmp(a->exec, b->exec) == 0 &&
+           strcmp(a->wm_class, b->wm_class) == 0 && strcmp(a->filename, b->filename) == 0 &&
+           a->show == b->show;
+}
+
+static DesktopIndexDiff *index_diff(DesktopIndex *previous, DesktopIndex *index) {
+    DesktopIndexDiff *diff = g_new0(DesktopIndexDiff, 1);
+    GHashTable *previous_ids = g_hash_table_new(g_str_hash, g_str_equal);   // id → posición
+    GHashTableIter iter;
+    gpointer value;
+
+    diff->removed = g_array_new(FALSE, FALSE, sizeof(guint));
+    diff->added = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    for (guint i = 0; i < previous->header->n_entries; i++) {
+        DesktopIndexEntry entry;
+        desktop_index_get_entry(previous, i, &entry);
+        g_hash_table_insert(previous_ids, (gpointer)entry.id, GUINT_TO_POINTER(i));
+    }
+
+    for (guint i = 0; i < index->header->n_entries; i++) {
+        DesktopIndexEntry entry;
+        desktop_index_get_entry(index, i, &entry);
+
+        if (!g_hash_table_lookup_extended(previous_ids, entry.id, NULL, &value)) {
+            g_array_append_val(diff->added, i);
+            continue;
+        }
+
+        guint old_position = GPOINTER_TO_UINT(value);
+        DesktopIndexEntry old_entry;
+        desktop_index_get_entry(previous, old_position, &old_entry);
+        g_hash_table_remove(previous_ids, entry.id);
+
+        if (!entries_equal(&old_entry, &entry)) {
+            g_array_append_val(diff->removed, old_position);
+            g_array_append_val(diff->added, i);
+        }
+    }
+
+    // Lo que queda ya no existe
+    g_hash_table_iter_init(&iter, previous_ids);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        guint old_position = GPOINTER_TO_UINT(value);
+        g_array_append_val(diff->removed, old_position);
+    }
+
+    g_hash_table_destroy(previous_ids);
+    return diff;
+}
+
+void desktop_index_diff_free(DesktopIndexDiff *diff) {
+    if (!diff) return;
+
+    g_array_unref(diff->removed);
+    g_array_unref(diff->added);
+    g_free(diff);
+}
+
+typedef struct {
+    DesktopIndex *index;
+    DesktopIndexDiff *diff;
+} RebuildResult;
+
+static void rebuild_result_free(RebuildResult *result) {
+    desktop_index_unref(result->index);
+    desktop_index_diff_free(result->diff);
+    g_free(result);
+}
+
+static void rebuild_thread(GTask *task, gpointer source_object G_GNUC_UNUSED,
+                           gpointer task_data, GCancellable *cancellable) {
+    DesktopIndex *previous = task_data;
+    gint64 start = g_get_monotonic_time();
+    IndexBuilder builder = {
+        .strings = g_string_new_len("", 1),
+        .offsets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL),
+        .dirs = g_array_new(FALSE, FALSE, sizeof(IndexDir)),
+        .entries = g_array_new(FALSE, FALSE, sizeof(IndexEntry)),
+    };
+    GPtrArray *dirs = application_dirs();
+    gchar *environment = index_environment(dirs);
+
+    // Los mtime se toman antes de leer: un cambio durante el recorrido deja
+    // el índice obsoleto para el próximo arranque en vez de incompleto
+    for (guint i = 0; i < dirs->len; i++) {
+        builder_add_dir(&builder, g_ptr_array_index(dirs, i), 0);
+    }
+
+    if (!g_cancellable_is_cancelled(cancellable)) {
+        GList *app_infos = g_app_info_get_all();
+        for (GList *l = app_infos; l != NULL; l = l->next) {
+            // También las NoDisplay: la caché de iconos las necesita para
+            // las ventanas de aplicaciones que no salen en el menú
+            if (G_IS_DESKTOP_APP_INFO(l->data)) {
+                builder_add_app(&builder, l->data);
+            }
+        }
+        g_list_free_full(app_infos, g_object_unref);
+
+        GBytes *bytes = builder_serialize(&builder, environment);
+        write_index(bytes);
+
+        RebuildResult *result = g_new0(RebuildResult, 1);
+        result->index = index_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+
+        if (previous) {
+            result->diff = index_diff(previous, result->index);
+        }
+
+        g_debug("Índice de aplicaciones: %u entradas en %.1f ms", result->index->header->n_entries,
+                (g_get_monotonic_time() - start) / 1000.0);
+        g_task_return_pointer(task, result, (GDestroyNotify)rebuild_result_free);
+    } else {
+        g_task_return_error_if_cancelled(task);
+    }
+
+    g_free(environment);
+    g_ptr_array_unref(dirs);
+    g_array_unref(builder.entries);
+    g_array_unref(builder.dirs);
+    g_hash_table_destroy(builder.offsets);
+    g_string_free(builder.strings, TRUE);
+}
+
+void desktop_index_rebuild_async(DesktopIndex *previous, GCancellable *cancellable,
+                                 GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task = g_task_new(NULL, cancellable, callback, user_data);
+    g_task_set_source_tag(task, desktop_index_rebuild_async);
+    if (previous) {
+        g_task_set_task_data(task, desktop_index_ref(previous), (GDestroyNotify)desktop_index_unref);
+    }
+    g_task_run_in_thread(task, rebuild_thread);
+    g_object_unref(task);
+}
+
+DesktopIndex *desktop_index_rebuild_finish(GAsyncResult *result, DesktopIndexDiff **diff,
+                                           GError **error) {
+    g_return_val_if_fail(g_task_is_valid(result, NULL), NULL);
+
+    RebuildResult *rebuild = g_task_propagate_pointer(G_TASK(result), error);
+    if (!rebuild) return NULL;
+
+    DesktopIndex *index = g_steal_pointer(&rebuild->index);
+    if (diff) {
+        *diff = g_steal_pointer(&rebuild->diff);
+    }
+    rebuild_result_free(rebuild);
+
+    return index;
+}
+
+static void prime_thread(GTask *task, gpointer source_object G_GNUC_UNUSED,
+                         gpointer task_data G_GNUC_UNUSED, GCancellable *cancellable G_GNUC_UNUSED) {
+    // Cualquier búsqueda sirve: GIO lista los directorios y los vigila, y un
+    // id que no existe no obliga a leer ningún archivo
+    GDesktopAppInfo *app_info = g_desktop_app_info_new("simple-panel-index-probe.desktop");
+    g_clear_object(&app_info);
+
+    g_task_return_boolean(task, TRUE);
+}
+
+void desktop_index_prime_app_info_monitor(void) {
+    GTask *task = g_task_new(NULL, NULL, NULL, NULL);
+    g_task_set_source_tag(task, desktop_index_prime_app_info_monitor);
+    g_task_run_in_thread(task, prime_thread);
+    g_object_unref(task);
+}
+
+DesktopIndex *desktop_index_ref(DesktopIndex *index) {
+    g_atomic_ref_count_inc(&index->ref_count);
+    return index;
+}
+
+void desktop_index_unref(DesktopIndex *index) {
+    if (!index || !g_atomic_ref_count_dec(&index->ref_count)) return;
+
+    g_bytes_unref(index->bytes);
+    g_free(index);
+}
+
+guint desktop_index_get_n_entries(DesktopIndex *index) {
+    return index->header->n_entries;
+}
+
+void desktop_index_get_entry(DesktopIndex *index, guint position, DesktopIndexEntry *entry) {
+    g_return_if_fail(position < index->header->n_entries);
+
+    const IndexEntry *raw = &index->entries[position];
+    entry->id = index->strings + raw->id;
+    entry->name = index->strings + raw->name;
+    entry->icon = index->strings + raw->icon;
+    entry->categories = index->strings + raw->categories;
+    entry->exec = index->strings + raw->exec;
+    entry->wm_class = index->strings + raw->wm_class;
+    entry->filename = index->strings + raw->filename;
+    entry->show = (raw->flags & INDEX_ENTRY_SHOW) != 0;
+}
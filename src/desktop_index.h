@@ -0,0 +1,57 @@
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+// Índice binario de las aplicaciones instaladas, guardado en
+// $XDG_CACHE_HOME/simple-panel/ y leído con mmap: mientras ningún directorio
+// applications cambie de mtime, arrancar no parsea ningún .desktop. Lo
+// comparten el menú y la caché de iconos a través de DesktopIndexMonitor.
+typedef struct _DesktopIndex DesktopIndex;
+
+// Las cadenas apuntan al índice y son válidas mientras viva
+typedef struct {
+    const gchar *id;            // "firefox.desktop"
+    const gchar *name;          // nombre visible en el idioma con que se construyó
+    const gchar *icon;          // g_icon_to_string(), "" si no tiene
+    const gchar *categories;    // "Network;WebBrowser;", "" si no tiene
+    const gchar *exec;
+    const gchar *wm_class;      // StartupWMClass, "" si no tiene
+    const gchar *filename;      // ruta del .desktop
+    gboolean show;              // FALSE para NoDisplay o fuera de OnlyShowIn/NotShowIn
+} DesktopIndexEntry;
+
+// Cambios entre dos índices; una entrada modificada cuenta como quitada y añadida
+typedef struct {
+    GArray *removed;            // guint: posiciones en el índice anterior
+    GArray *added;              // guint: posiciones en el nuevo
+} DesktopIndexDiff;
+
+// Índice del disco o NULL si no existe o no es válido. `stale` es TRUE si
+// algún directorio cambió desde que se construyó: el índice sigue siendo
+// usable mientras se reconstruye
+DesktopIndex *desktop_index_load(gboolean *stale);
+
+// Recorrer los .desktop y reescribir el índice en un hilo aparte. Con
+// `previous` la comparación con el índice nuevo también se hace en ese hilo
+void desktop_index_rebuild_async(DesktopIndex *previous, GCancellable *cancellable,
+                                 GAsyncReadyCallback callback, gpointer user_data);
+// `diff` queda a NULL si no se pasó `previous`
+DesktopIndex *desktop_index_rebuild_finish(GAsyncResult *result, DesktopIndexDiff **diff,
+                                           GError **error);
+
+void desktop_index_diff_free(DesktopIndexDiff *diff);
+
+// GAppInfoMonitor solo avisa de cambios después de que GIO cargue su caché de
+// aplicaciones, cosa que un índice válido evita. Esto la carga en un hilo
+// aparte sin parsear ningún .desktop
+void desktop_index_prime_app_info_monitor(void);
+
+DesktopIndex *desktop_index_ref(DesktopIndex *index);
+void desktop_index_unref(DesktopIndex *index);
+
+guint desktop_index_get_n_entries(DesktopIndex *index);
+void desktop_index_get_entry(DesktopIndex *index, guint position, DesktopIndexEntry *entry);
+
+G_END_DECLS
@@ -0,0 +1,160 @@
+#include "desktop_index_monitor.h"
+
+// Las actualizaciones de paquetes escriben muchos .desktop seguidos: esperar
+// a que paren antes de reconstruir
+#define UPDATE_DELAY_MS 1000
+
+struct _DesktopIndexMonitor {
+    GObject parent_instance;
+
+    DesktopIndex *index;
+    GCancellable *cancellable;  // reconstrucción en curso
+
+    GAppInfoMonitor *app_info_monitor;
+    gulong app_info_monitor_handler;
+    guint update_id;
+    gboolean update_pending;    // llegaron cambios durante la reconstrucción
+};
+
+enum {
+    SIGNAL_CHANGED,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+G_DEFINE_TYPE(DesktopIndexMonitor, desktop_index_monitor, G_TYPE_OBJECT)
+
+static void start_rebuild(DesktopIndexMonitor *self);
+
+static void on_index_rebuilt(GObject *source G_GNUC_UNUSED, GAsyncResult *result, gpointer user_data) {
+    GError *error = NULL;
+    DesktopIndexDiff *diff = NULL;
+    DesktopIndex *index = desktop_index_rebuild_finish(result, &diff, &error);
+
+    // Solo falla si se canceló, y entonces el monitor ya no existe
+    if (!index) {
+        g_error_free(error);
+        return;
+    }
+
+    DesktopIndexMonitor *self = DESKTOP_INDEX_MONITOR(user_data);
+    g_clear_object(&self->cancellable);
+
+    DesktopIndex *previous = self->index;
+    self->index = index;
+
+    g_signal_emit(self, signals[SIGNAL_CHANGED], 0, previous, diff);
+
+    if (previous) {
+        desktop_index_unref(previous);
+    }
+    desktop_index_diff_free(diff);
+
+    if (self->update_pending) {
+        self->update_pending = FALSE;
+        start_rebuild(self);
+    }
+}
+
+// El recorrido y la comparación con el índice actual van en otro hilo
+static void start_rebuild(DesktopIndexMonitor *self) {
+    self->cancellable = g_cancellable_new();
+    desktop_index_rebuild_async(self->index, self->cancellable, on_index_rebuilt, self);
+}
+
+static gboolean on_update_timeout(gpointer user_data) {
+    DesktopIndexMonitor *self = DESKTOP_INDEX_MONITOR(user_data);
+
+    self->update_id = 0;
+
+    if (self->cancellable) {
+        self->update_pending = TRUE;
+    } else {
+        start_rebuild(self);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+// Se ha instalado, quitado o modificado alguna aplicación
+static void on_app_info_changed(GAppInfoMonitor *monitor G_GNUC_UNUSED, gpointer user_data) {
+    DesktopIndexMonitor *self = DESKTOP_INDEX_MONITOR(user_data);
+
+    if (self->update_id > 0) {
+        g_source_remove(self->update_id);
+    }
+    self->update_id = g_timeout_add(UPDATE_DELAY_MS, on_update_timeout, self);
+}
+
+DesktopIndex *desktop_index_monitor_get_index(DesktopIndexMonitor *self) {
+    g_return_val_if_fail(DESKTOP_IS_INDEX_MONITOR(self), NULL);
+    return self->index;
+}
+
+static void desktop_index_monitor_dispose(GObject *object) {
+    DesktopIndexMonitor *self = DESKTOP_INDEX_MONITOR(object);
+
+    if (self->app_info_monitor) {
+        g_signal_handler_disconnect(self->app_info_monitor, self->app_info_monitor_handler);
+        g_clear_object(&self->app_info_monitor);
+    }
+
+    if (self->update_id > 0) {
+        g_source_remove(self->update_id);
+        self->update_id = 0;
+    }
+
+    if (self->cancellable) {
+        g_cancellable_cancel(self->cancellable);
+        g_clear_object(&self->cancellable);
+    }
+
+    if (self->index) {
+        desktop_index_unref(self->index);
+        self->index = NULL;
+    }
+
+    G_OBJECT_CLASS(desktop_index_monitor_parent_class)->dispose(object);
+}
+
+static void desktop_index_monitor_init(DesktopIndexMonitor *self) {
+    gboolean stale;
+
+    // El índice en disco evita parsear todos los .desktop al arrancar; si algún
+    // directorio cambió se usa igualmente y se reconstruye en segundo plano
+    self->index = desktop_index_load(&stale);
+    if (stale) {
+        start_rebuild(self);
+    } else {
+        desktop_index_prime_app_info_monitor();
+    }
+
+    self->app_info_monitor = g_app_info_monitor_get();
+    self->app_info_monitor_handler = g_signal_connect(self->app_info_monitor, "changed",
+                                                      G_CALLBACK(on_app_info_changed), self);
+}
+
+static void desktop_index_monitor_class_init(DesktopIndexMonitorClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = desktop_index_monitor_dispose;
+
+    // Hay un índice nuevo: (DesktopIndex *previous, DesktopIndexDiff *diff),
+    // válidos solo durante la emisión
+    signals[SIGNAL_CHANGED] = g_signal_new("changed",
+                                           G_TYPE_FROM_CLASS(klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 2,
+                                           G_TYPE_POINTER, G_TYPE_POINTER);
+}
+
+DesktopIndexMonitor *desktop_index_monitor_get_default(void) {
+    static DesktopIndexMonitor *default_monitor = NULL;
+
+    if (!default_monitor) {
+        default_monitor = g_object_new(DESKTOP_TYPE_INDEX_MONITOR, NULL);
+    }
+
+    return default_monitor;
+}
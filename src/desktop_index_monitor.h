@@ -0,0 +1,20 @@
+#pragma once
+
+#include "desktop_index.h"
+
+G_BEGIN_DECLS
+
+// Dueño del DesktopIndex que comparten el menú y la caché de iconos. Lo carga
+// del disco al crearse y lo reconstruye en otro hilo si está obsoleto o cuando
+// GAppInfoMonitor avisa de cambios. Cada índice nuevo se anuncia con
+// "changed" (previous, diff): ambos son NULL si no había índice anterior.
+#define DESKTOP_TYPE_INDEX_MONITOR (desktop_index_monitor_get_type())
+G_DECLARE_FINAL_TYPE(DesktopIndexMonitor, desktop_index_monitor, DESKTOP, INDEX_MONITOR, GObject)
+
+DesktopIndexMonitor *desktop_index_monitor_get_default(void);
+
+// Índice actual o NULL mientras se construye el primero. Para conservarlo
+// más allá del siguiente "changed" hay que tomar una referencia
+DesktopIndex *desktop_index_monitor_get_index(DesktopIndexMonitor *self);
+
+G_END_DECLS
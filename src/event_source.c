@@ -0,0 +1,160 @@
+#define _GNU_SOURCE
+#include "event_source.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+typedef struct {
+    GSource source;
+    int fd;
+    gpointer tag;
+} FdSource;
+
+static void fd_source_finalize(GSource *source) {
+    FdSource *self = (FdSource *)source;
+
+    if (self->fd >= 0) {
+        close(self->fd);
+        self->fd = -1;
+    }
+}
+
+static GSource *fd_source_new(GSourceFuncs *funcs, int fd, GIOCondition condition, const gchar *name) {
+    GSource *source = g_source_new(funcs, sizeof(FdSource));
+    FdSource *self = (FdSource *)source;
+
+    self->fd = fd;
+    self->tag = g_source_add_unix_fd(source, fd, condition);
+    g_source_set_name(source, name);
+
+    return source;
+}
+
+// --- timerfd ---
+
+static gboolean deadline_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    FdSource *self = (FdSource *)source;
+    guint64 expirations;
+
+    // Consumir la expiración; ECANCELED indica que el reloj de pared cambió,
+    // que también es motivo para despertar y recalcular
+    if (read(self->fd, &expirations, sizeof(expirations)) < 0 && errno != ECANCELED) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    return callback ? callback(user_data) : G_SOURCE_REMOVE;
+}
+
+static GSourceFuncs deadline_source_funcs = {
+    .dispatch = deadline_source_dispatch,
+    .finalize = fd_source_finalize,
+};
+
+GSource *deadline_source_new(void) {
+    int fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        g_debug("timerfd no disponible: %s", g_strerror(errno));
+        return NULL;
+    }
+
+    return fd_source_new(&deadline_source_funcs, fd, G_IO_IN, "deadline");
+}
+
+// Mayor paso "redondo" que cabe en la tolerancia
+static gint64 deadline_grid(guint tolerance_ms) {
+    static const guint steps_ms[] = { 1000, 500, 250, 100, 50, 10, 1 };
+
+    for (guint i = 0; i < G_N_ELEMENTS(steps_ms); i++) {
+        if (tolerance_ms >= steps_ms[i]) return (gint64)steps_ms[i] * 1000;
+    }
+    return 0;
+}
+
+void deadline_source_set_deadline(GSource *source, gint64 deadline_us, guint tolerance_ms) {
+    FdSource *self = (FdSource *)source;
+    struct itimerspec spec;
+
+    memset(&spec, 0, sizeof(spec));
+
+    if (deadline_us >= 0) {
+        gint64 grid = deadline_grid(tolerance_ms);
+
+        // Primer múltiplo del paso dentro de [deadline, deadline + tolerancia]
+        if (grid > 0) {
+            deadline_us = (deadline_us + grid - 1) / grid * grid;
+        }
+
+        // it_value a cero desarmaría el temporizador
+        deadline_us = MAX(deadline_us, 1);
+        spec.it_value.tv_sec = deadline_us / G_USEC_PER_SEC;
+        spec.it_value.tv_nsec = (deadline_us % G_USEC_PER_SEC) * 1000;
+    }
+
+    if (timerfd_settime(self->fd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, NULL) < 0) {
+        g_warning("No se pudo programar el timerfd: %s", g_strerror(errno));
+    }
+}
+
+// --- PSI ---
+
+static gboolean psi_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    FdSource *self = (FdSource *)source;
+    GIOCondition revents = g_source_query_unix_fd(source, self->tag);
+
+    // El kernel invalida el trigger si desaparece el cgroup o el archivo
+    if (revents & G_IO_ERR) {
+        g_debug("Trigger de PSI invalidado");
+        return G_SOURCE_REMOVE;
+    }
+
+    return callback ? callback(user_data) : G_SOURCE_REMOVE;
+}
+
+static GSourceFuncs psi_source_funcs = {
+    .dispatch = psi_source_dispatch,
+    .finalize = fd_source_finalize,
+};
+
+GSource *psi_trigger_source_new(const gchar *path, const gchar *trigger) {
+    int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        g_debug("PSI no disponible en %s: %s", path, g_strerror(errno));
+        return NULL;
+    }
+
+    // El NUL final forma parte del formato que espera el kernel
+    if (write(fd, trigger, strlen(trigger) + 1) < 0) {
+        g_debug("No se pudo crear el trigger de PSI: %s", g_strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    return fd_source_new(&psi_source_funcs, fd, G_IO_PRI | G_IO_ERR, "psi-trigger");
+}
+
+// --- Despertar entre hilos ---
+
+static gboolean wakeup_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data) {
+    // Rearmar antes del callback: una señal que llegue durante él no se pierde
+    g_source_set_ready_time(source, -1);
+
+    return callback ? callback(user_data) : G_SOURCE_REMOVE;
+}
+
+static GSourceFuncs wakeup_source_funcs = {
+    .dispatch = wakeup_source_dispatch,
+};
+
+GSource *wakeup_source_new(void) {
+    GSource *source = g_source_new(&wakeup_source_funcs, sizeof(GSource));
+
+    g_source_set_name(source, "wakeup");
+    return source;
+}
+
+void wakeup_source_signal(GSource *source) {
+    // Con la fuente adjunta a un contexto es seguro desde cualquier hilo
+    g_source_set_ready_time(source, 0);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Fuentes de eventos del kernel expuestas como GSource, para despertar por
+// plazos y umbrales en lugar de con temporizadores de intervalo fijo.
+
+// Temporizador timerfd sobre CLOCK_REALTIME con plazos absolutos
+// (TFD_TIMER_ABSTIME). Sigue contando durante la suspensión y se dispara en
+// cuanto el reloj de pared cambia (TFD_TIMER_CANCEL_ON_SET), así el callback
+// puede recalcular sus plazos. NULL si el sistema no tiene timerfd.
+GSource *deadline_source_new(void);
+
+// Despertar en `deadline_us` (tiempo real, µs) o hasta `tolerance_ms` más
+// tarde. El kernel no aplica la holgura de PR_SET_TIMERSLACK a los timerfd, así
+// que la tolerancia no se le pasa: el plazo se lleva al primer múltiplo
+// "redondo" (1 s, 500 ms, 250 ms...) dentro de la ventana, de modo que los
+// despertares con ventanas solapadas coinciden entre sí y con los
+// temporizadores de segundos del resto del sistema. Un plazo negativo desarma
+// el temporizador.
+void deadline_source_set_deadline(GSource *source, gint64 deadline_us, guint tolerance_ms);
+
+// Trigger de PSI (`trigger` con el formato "some|full <stall µs> <ventana µs>")
+// sobre un archivo de /proc/pressure. El callback se llama cada vez que el
+// kernel señala el umbral; la fuente se destruye sola si el kernel invalida el
+// trigger. NULL si PSI no está disponible o no se permite crear el trigger.
+GSource *psi_trigger_source_new(const gchar *path, const gchar *trigger);
+
+// Fuente que se despierta desde cualquier hilo con wakeup_source_signal().
+// Varias señales antes del despacho se atienden en un solo callback, así que
+// los datos deben pasarse aparte (por ejemplo con operaciones atómicas) y
+// publicarse antes de señalar.
+GSource *wakeup_source_new(void);
+void wakeup_source_signal(GSource *source);
+
+G_END_DECLS
@@ -0,0 +1,125 @@
+#include "monitor_activity.h"
+
+// Redibujos seguidos sin pintar antes de considerar la superficie oculta
+#define MISSED_DRAWS_HIDDEN 3
+
+struct _MonitorActivity {
+    GtkWidget *widget;
+    SystemMonitor *monitor;
+    guint sources;
+
+    gulong map_handler;
+    gulong unmap_handler;
+    gulong tooltip_handler;
+
+    gboolean mapped;
+    gboolean occluded;
+    gboolean counted;   // si el muestreador nos cuenta como visibles
+    gboolean draw_pending;
+    guint missed_draws;
+};
+
+static void set_sources_visible(MonitorActivity *activity, gboolean visible) {
+    for (guint i = 0; i < 32; i++) {
+        if (activity->sources & (1u << i)) {
+            system_monitor_set_visible(activity->monitor, 1u << i, visible);
+        }
+    }
+}
+
+static void sync_visibility(MonitorActivity *activity) {
+    gboolean visible = activity->mapped && !activity->occluded;
+
+    if (visible == activity->counted) return;
+
+    activity->counted = visible;
+    set_sources_visible(activity, visible);
+}
+
+static void on_map(GtkWidget *widget G_GNUC_UNUSED, gpointer user_data) {
+    MonitorActivity *activity = user_data;
+
+    activity->mapped = TRUE;
+    sync_visibility(activity);
+}
+
+static void on_unmap(GtkWidget *widget G_GNUC_UNUSED, gpointer user_data) {
+    MonitorActivity *activity = user_data;
+
+    activity->mapped = FALSE;
+    activity->occluded = FALSE;
+    activity->draw_pending = FALSE;
+    activity->missed_draws = 0;
+    sync_visibility(activity);
+}
+
+// Se conecta antes del manejador por defecto y devuelve FALSE para que el
+// tooltip de texto se siga mostrando
+static gboolean on_query_tooltip(GtkWidget *widget G_GNUC_UNUSED, int x G_GNUC_UNUSED,
+                                 int y G_GNUC_UNUSED, gboolean keyboard_mode G_GNUC_UNUSED,
+                                 GtkTooltip *tooltip G_GNUC_UNUSED, gpointer user_data) {
+    monitor_activity_boost(user_data);
+    return FALSE;
+}
+
+MonitorActivity *monitor_activity_new(GtkWidget *widget, SystemMonitor *monitor, guint sources) {
+    MonitorActivity *activity = g_new0(MonitorActivity, 1);
+    activity->widget = widget;
+    activity->monitor = monitor;
+    activity->sources = sources;
+
+    activity->map_handler = g_signal_connect(widget, "map", G_CALLBACK(on_map), activity);
+    activity->unmap_handler = g_signal_connect(widget, "unmap", G_CALLBACK(on_unmap), activity);
+    activity->tooltip_handler = g_signal_connect(widget, "query-tooltip",
+                                                 G_CALLBACK(on_query_tooltip), activity);
+
+    activity->mapped = gtk_widget_get_mapped(widget);
+    sync_visibility(activity);
+
+    return activity;
+}
+
+void monitor_activity_free(MonitorActivity *activity) {
+    if (!activity) return;
+
+    g_clear_signal_handler(&activity->map_handler, activity->widget);
+    g_clear_signal_handler(&activity->unmap_handler, activity->widget);
+    g_clear_signal_handler(&activity->tooltip_handler, activity->widget);
+
+    if (activity->counted) {
+        set_sources_visible(activity, FALSE);
+    }
+
+    g_free(activity);
+}
+
+// En Wayland GTK no pinta mientras el compositor no manda frame callbacks,
+// que es lo que ocurre con la salida apagada o la superficie tapada
+void monitor_activity_queue_draw(MonitorActivity *activity, GtkWidget *area) {
+    if (activity->draw_pending && activity->mapped &&
+        ++activity->missed_draws >= MISSED_DRAWS_HIDDEN) {
+        activity->occluded = TRUE;
+        sync_visibility(activity);
+    }
+
+    activity->draw_pending = TRUE;
+    gtk_widget_queue_draw(area);
+}
+
+void monitor_activity_drawn(MonitorActivity *activity) {
+    activity->draw_pending = FALSE;
+    activity->missed_draws = 0;
+
+    if (activity->occluded) {
+        activity->occluded = FALSE;
+        sync_visibility(activity);
+    }
+}
+
+void monitor_activity_boost(MonitorActivity *activity) {
+    for (guint i = 0; i < 32; i++) {
+        if (activity->sources & (1u << i)) {
+            system_monitor_boost(activity->monitor, 1u << i);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "system_monitor.h"
+
+G_BEGIN_DECLS
+
+// Enlaza un widget de monitorización con el muestreo adaptativo: informa al
+// muestreador de si el widget está en pantalla y de cuándo el usuario lo mira
+typedef struct _MonitorActivity MonitorActivity;
+
+// `sources` es la máscara de SystemMonitorSource a las que está suscrito el widget
+MonitorActivity *monitor_activity_new(GtkWidget *widget, SystemMonitor *monitor, guint sources);
+void monitor_activity_free(MonitorActivity *activity);
+
+// Sustituyen a gtk_widget_queue_draw y se llaman desde la función de dibujo:
+// si los redibujos pedidos no llegan a pintarse la superficie está tapada
+void monitor_activity_queue_draw(MonitorActivity *activity, GtkWidget *area);
+void monitor_activity_drawn(MonitorActivity *activity);
+
+// El usuario está mirando (tooltip, popover): volver al intervalo base
+void monitor_activity_boost(MonitorActivity *activity);
+
+G_END_DECLS
@@ -0,0 +1,293 @@
+#include "monitor_graph.h"
+#include "monitor_ring.h"
+
+typedef struct {
+    double red;
+    double green;
+    double blue;
+    gboolean fill;
+    MonitorRing *history;
+} GraphSeries;
+
+struct _MonitorGraph {
+    guint n_series;
+    guint history_size;
+    GraphSeries series[MONITOR_GRAPH_MAX_SERIES];
+    double max_value;
+
+    // Modo incremental: las series se dibujan en una superficie propia que
+    // se desplaza a la izquierda y solo recibe los segmentos nuevos
+    gboolean scrolling;
+    cairo_surface_t *plot;
+    cairo_surface_t *scratch;
+    int plot_width;
+    int plot_height;
+    int plot_scale;
+    gboolean plot_valid;
+    guint pending;
+};
+
+MonitorGraph *monitor_graph_new(guint n_series, guint history_size,
+                                MonitorRingScale scale, double range) {
+    g_return_val_if_fail(n_series > 0 && n_series <= MONITOR_GRAPH_MAX_SERIES, NULL);
+    g_return_val_if_fail(history_size >= 2, NULL);
+
+    MonitorGraph *graph = g_malloc0(sizeof(MonitorGraph));
+    graph->n_series = n_series;
+    graph->history_size = history_size;
+    graph->max_value = 100.0;
+
+    for (guint i = 0; i < n_series; i++) {
+        graph->series[i].history = monitor_ring_new(history_size, scale, range);
+    }
+
+    return graph;
+}
+
+void monitor_graph_free(MonitorGraph *graph) {
+    if (!graph) return;
+
+    for (guint i = 0; i < graph->n_series; i++) {
+        monitor_ring_free(graph->series[i].history);
+    }
+
+    if (graph->plot) {
+        cairo_surface_destroy(graph->plot);
+    }
+    if (graph->scratch) {
+        cairo_surface_destroy(graph->scratch);
+    }
+
+    g_free(graph);
+}
+
+void monitor_graph_set_color(MonitorGraph *graph, guint series, double red, double green, double blue) {
+    g_return_if_fail(series < graph->n_series);
+
+    graph->series[series].red = red;
+    graph->series[series].green = green;
+    graph->series[series].blue = blue;
+    graph->plot_valid = FALSE;
+}
+
+void monitor_graph_set_fill(MonitorGraph *graph, guint series, gboolean fill) {
+    g_return_if_fail(series < graph->n_series);
+    graph->series[series].fill = fill;
+    graph->plot_valid = FALSE;
+}
+
+void monitor_graph_set_max(MonitorGraph *graph, double max_value) {
+    if (max_value == graph->max_value) return;
+
+    // Cambio de escala: lo ya dibujado deja de servir
+    graph->max_value = max_value;
+    graph->plot_valid = FALSE;
+}
+
+void monitor_graph_set_scrolling(MonitorGraph *graph, gboolean scrolling) {
+    graph->scrolling = scrolling;
+    graph->plot_valid = FALSE;
+}
+
+void monitor_graph_push(MonitorGraph *graph, const double *values) {
+    for (guint i = 0; i < graph->n_series; i++) {
+        monitor_ring_push(graph->series[i].history, values[i]);
+    }
+
+    graph->pending = MIN(graph->pending + 1, graph->history_size);
+}
+
+void monitor_graph_push_repeat(MonitorGraph *graph, const double *values, guint count) {
+    // Más allá del tamaño del historial las repeticiones se pisarían entre sí
+    count = MIN(count, graph->history_size);
+
+    for (guint i = 0; i < count; i++) {
+        monitor_graph_push(graph, values);
+    }
+}
+
+// Valor de hace `age` muestras (0 = la más reciente)
+static double series_value_at_age(const MonitorGraph *graph, const GraphSeries *series, guint age) {
+    return MIN(monitor_ring_get(series->history, age), graph->max_value);
+}
+
+// Un solo paint semitransparente: más barato que componer una superficie cacheada
+static void draw_background(cairo_t *cr) {
+    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.3);
+    cairo_paint(cr);
+}
+
+// Añadir toda la serie al path actual como una sola polilínea (de la más antigua a la más nueva).
+// Con historiales largos se agrupan las muestras en como mucho un punto por píxel,
+// quedándose con el máximo de cada grupo para no perder los picos
+static void append_polyline(MonitorGraph *graph, const GraphSeries *series,
+                            cairo_t *cr, int width, int height) {
+    guint points = MIN(graph->history_size, (guint)width + 1);
+    double bucket = (double)graph->history_size / points;
+    double x_step = (double)width / MAX(points - 1, 1);
+    double scale = (double)height / graph->max_value;
+
+    for (guint i = 0; i < points; i++) {
+        guint oldest = graph->history_size - 1 - (guint)(i * bucket);
+        guint newest = graph->history_size - (guint)((i + 1) * bucket);
+        double value = 0.0;
+
+        for (guint age = newest; age <= oldest; age++) {
+            value = MAX(value, series_value_at_age(graph, series, age));
+        }
+
+        double y = height - value * scale;
+        if (i == 0) {
+            cairo_move_to(cr, 0, y);
+        } else {
+            cairo_line_to(cr, i * x_step, y);
+        }
+    }
+}
+
+// En modo incremental cada muestra ocupa un número entero de píxeles para
+// que desplazar la superficie no difumine lo ya dibujado
+static int scrolling_step(const MonitorGraph *graph, int width) {
+    return MAX(1, width / (int)(graph->history_size - 1));
+}
+
+// Dibujar las muestras con edad entre `oldest` y 0, alineadas al borde derecho
+static void draw_recent_segments(MonitorGraph *graph, cairo_t *cr, guint oldest,
+                                 int width, int height) {
+    int step = scrolling_step(graph, width);
+    double scale = (double)height / graph->max_value;
+
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+
+    for (guint s = 0; s < graph->n_series; s++) {
+        const GraphSeries *series = &graph->series[s];
+
+        cairo_new_path(cr);
+        for (guint age = oldest + 1; age-- > 0;) {
+            double x = width - (double)age * step;
+            double y = height - series_value_at_age(graph, series, age) * scale;
+            if (age == oldest) {
+                cairo_move_to(cr, x, y);
+            } else {
+                cairo_line_to(cr, x, y);
+            }
+        }
+
+        if (series->fill) {
+            cairo_path_t *line = cairo_copy_path(cr);
+            cairo_line_to(cr, width, height);
+            cairo_line_to(cr, width - (double)oldest * step, height);
+            cairo_close_path(cr);
+            cairo_set_source_rgba(cr, series->red, series->green, series->blue, 0.3);
+            cairo_fill(cr);
+            cairo_append_path(cr, line);
+            cairo_path_destroy(line);
+        }
+
+        cairo_set_source_rgba(cr, series->red, series->green, series->blue, 1.0);
+        cairo_stroke(cr);
+    }
+}
+
+// Superficie de imagen a la resolución del monitor. cairo_surface_create_similar()
+// sobre el destino de un draw func de GTK4 daría una superficie de grabación, y
+// cada fotograma anidaría la grabación anterior
+static cairo_surface_t *create_plot_surface(int width, int height, int scale_factor) {
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                          width * scale_factor,
+                                                          height * scale_factor);
+    cairo_surface_set_device_scale(surface, scale_factor, scale_factor);
+    return surface;
+}
+
+// Coste por tick O(1) respecto al historial: desplazar y añadir los segmentos nuevos
+static void update_plot_surface(MonitorGraph *graph, int width, int height, int scale_factor) {
+    int step = scrolling_step(graph, width);
+    guint visible = MIN(graph->series[0].history->length, (guint)(width / step) + 1);
+
+    if (!graph->plot || graph->plot_width != width || graph->plot_height != height ||
+        graph->plot_scale != scale_factor) {
+        graph->plot_valid = FALSE;
+    }
+
+    if (graph->plot_valid && graph->pending == 0) return;
+
+    if (graph->plot_valid && (int)graph->pending * step < width && graph->pending < visible) {
+        // Doble buffer: copiar desplazado sobre scratch e intercambiar
+        cairo_t *scroll = cairo_create(graph->scratch);
+        cairo_set_operator(scroll, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(scroll, graph->plot, -(double)graph->pending * step, 0);
+        cairo_paint(scroll);
+        cairo_set_operator(scroll, CAIRO_OPERATOR_OVER);
+        draw_recent_segments(graph, scroll, graph->pending, width, height);
+        cairo_destroy(scroll);
+
+        cairo_surface_t *tmp = graph->plot;
+        graph->plot = graph->scratch;
+        graph->scratch = tmp;
+    } else {
+        // Redibujo completo: primera vez, cambio de tamaño o de escala
+        if (!graph->plot || graph->plot_width != width || graph->plot_height != height ||
+            graph->plot_scale != scale_factor) {
+            if (graph->plot) cairo_surface_destroy(graph->plot);
+            if (graph->scratch) cairo_surface_destroy(graph->scratch);
+            graph->plot = create_plot_surface(width, height, scale_factor);
+            graph->scratch = create_plot_surface(width, height, scale_factor);
+            graph->plot_width = width;
+            graph->plot_height = height;
+            graph->plot_scale = scale_factor;
+        }
+
+        cairo_t *plot = cairo_create(graph->plot);
+        cairo_set_operator(plot, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(plot);
+        cairo_set_operator(plot, CAIRO_OPERATOR_OVER);
+        if (visible >= 2) {
+            draw_recent_segments(graph, plot, visible - 1, width, height);
+        }
+        cairo_destroy(plot);
+        graph->plot_valid = TRUE;
+    }
+
+    graph->pending = 0;
+}
+
+void monitor_graph_draw(MonitorGraph *graph, cairo_t *cr, int width, int height, int scale_factor) {
+    if (width <= 0 || height <= 0) return;
+
+    draw_background(cr);
+
+    if (graph->max_value <= 0) return;
+
+    if (graph->scrolling) {
+        update_plot_surface(graph, width, height, MAX(scale_factor, 1));
+        cairo_set_source_surface(cr, graph->plot, 0, 0);
+        cairo_paint(cr);
+        return;
+    }
+
+    cairo_set_line_width(cr, 1.0);
+    cairo_set_line_join(cr, CAIRO_LINE_JOIN_ROUND);
+
+    for (guint s = 0; s < graph->n_series; s++) {
+        const GraphSeries *series = &graph->series[s];
+
+        // Área bajo la curva (opcional), cerrando la polilínea por abajo
+        if (series->fill) {
+            cairo_new_path(cr);
+            append_polyline(graph, series, cr, width, height);
+            cairo_line_to(cr, width, height);
+            cairo_line_to(cr, 0, height);
+            cairo_close_path(cr);
+            cairo_set_source_rgba(cr, series->red, series->green, series->blue, 0.3);
+            cairo_fill(cr);
+        }
+
+        // Un único stroke por serie
+        cairo_new_path(cr);
+        append_polyline(graph, series, cr, width, height);
+        cairo_set_source_rgba(cr, series->red, series->green, series->blue, 1.0);
+        cairo_stroke(cr);
+    }
+}
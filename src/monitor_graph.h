@@ -0,0 +1,36 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "monitor_ring.h"
+
+G_BEGIN_DECLS
+
+#define MONITOR_GRAPH_MAX_SERIES 2
+
+// Gráfica de historial compartida por los widgets de monitorización.
+// Guarda el historial de cada serie y lo dibuja como una sola polilínea.
+typedef struct _MonitorGraph MonitorGraph;
+
+// `scale` y `range` indican cómo se cuantiza el historial (ver MonitorRing)
+MonitorGraph *monitor_graph_new(guint n_series, guint history_size,
+                                MonitorRingScale scale, double range);
+void monitor_graph_free(MonitorGraph *graph);
+
+void monitor_graph_set_color(MonitorGraph *graph, guint series, double red, double green, double blue);
+void monitor_graph_set_fill(MonitorGraph *graph, guint series, gboolean fill);
+void monitor_graph_set_max(MonitorGraph *graph, double max_value);
+
+// Modo incremental: desplaza una superficie cacheada y dibuja solo lo nuevo
+void monitor_graph_set_scrolling(MonitorGraph *graph, gboolean scrolling);
+
+// Añadir una muestra (un valor por serie)
+void monitor_graph_push(MonitorGraph *graph, const double *values);
+
+// Añadir la misma muestra `count` veces (lecturas que cubren varios intervalos)
+void monitor_graph_push_repeat(MonitorGraph *graph, const double *values, guint count);
+
+// `scale_factor` es el del widget (gtk_widget_get_scale_factor): el modo
+// incremental guarda su superficie a esa resolución
+void monitor_graph_draw(MonitorGraph *graph, cairo_t *cr, int width, int height, int scale_factor);
+
+G_END_DECLS
@@ -0,0 +1,62 @@
+#include "monitor_ring.h"
+#include <math.h>
+
+// 2048 pasos por cada duplicación: hasta 2^32 con un error relativo < 0.04%
+#define LOG_STEPS_PER_OCTAVE 2048.0
+
+MonitorRing *monitor_ring_new(guint capacity, MonitorRingScale scale, double max_value) {
+    g_return_val_if_fail(capacity > 0, NULL);
+
+    MonitorRing *ring = g_malloc0(sizeof(MonitorRing));
+    ring->samples = g_new0(guint16, capacity);
+    ring->capacity = capacity;
+    ring->scale = scale;
+    ring->max_value = max_value > 0 ? max_value : 1.0;
+
+    return ring;
+}
+
+void monitor_ring_free(MonitorRing *ring) {
+    if (!ring) return;
+
+    g_free(ring->samples);
+    g_free(ring);
+}
+
+static guint16 quantize(const MonitorRing *ring, double value) {
+    double q;
+
+    if (value <= 0 || isnan(value)) return 0;
+
+    if (ring->scale == MONITOR_RING_LOG) {
+        q = log2(1.0 + value) * LOG_STEPS_PER_OCTAVE;
+    } else {
+        q = value / ring->max_value * G_MAXUINT16;
+    }
+
+    return (guint16)MIN(q + 0.5, (double)G_MAXUINT16);
+}
+
+static double dequantize(const MonitorRing *ring, guint16 q) {
+    if (ring->scale == MONITOR_RING_LOG) {
+        return exp2(q / LOG_STEPS_PER_OCTAVE) - 1.0;
+    }
+
+    return q * ring->max_value / G_MAXUINT16;
+}
+
+void monitor_ring_push(MonitorRing *ring, double value) {
+    ring->samples[ring->head] = quantize(ring, value);
+    ring->head = (ring->head + 1) % ring->capacity;
+
+    if (ring->length < ring->capacity) {
+        ring->length++;
+    }
+}
+
+double monitor_ring_get(const MonitorRing *ring, guint age) {
+    if (age >= ring->length) return 0.0;
+
+    guint idx = (ring->head + ring->capacity - 1 - age) % ring->capacity;
+    return dequantize(ring, ring->samples[idx]);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Cómo se cuantiza cada muestra a 16 bits
+typedef enum {
+    MONITOR_RING_LINEAR,    // [0, max_value] en pasos uniformes (porcentajes)
+    MONITOR_RING_LOG,       // log2(1 + v): error relativo constante (velocidades)
+} MonitorRingScale;
+
+// Buffer circular de muestras cuantizadas a guint16: una hora a 1 Hz son 7 KB
+typedef struct {
+    guint16 *samples;
+    guint capacity;
+    guint head;
+    guint length;
+    MonitorRingScale scale;
+    double max_value;
+} MonitorRing;
+
+MonitorRing *monitor_ring_new(guint capacity, MonitorRingScale scale, double max_value);
+void monitor_ring_free(MonitorRing *ring);
+
+void monitor_ring_push(MonitorRing *ring, double value);
+
+// Muestra de hace `age` posiciones (0 = la más reciente); 0 si aún no existe
+double monitor_ring_get(const MonitorRing *ring, guint age);
+
+G_END_DECLS
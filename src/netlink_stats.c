@@ -0,0 +1,293 @@
+#define _GNU_SOURCE
+#include "netlink_stats.h"
+#include <glib-unix.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+
+// El kernel trocea los volcados en mensajes de como mucho unos 32 KB
+#define NETLINK_BUFFER_SIZE 65536
+
+// La primera petición es un RTM_GETLINK (nombres y contadores, IFLA_STATS64).
+// Las siguientes usan RTM_GETSTATS filtrado a IFLA_STATS_LINK_64, que solo trae
+// los contadores y es un orden de magnitud más barato con cientos de
+// interfaces; los nombres se mantienen con las notificaciones de RTMGRP_LINK.
+struct _NetlinkStats {
+    int fd;
+    GSource *watch;
+    guint32 seq;
+    gboolean in_flight;
+    gboolean use_getstats;  // FALSE en kernels sin RTM_GETSTATS (< 4.7)
+    guint16 request_type;
+    guint8 *buffer;
+
+    // ifindex → nombre
+    GHashTable *names;
+
+    NetlinkStatsLinkFunc link_func;
+    NetlinkStatsDoneFunc done_func;
+    gpointer user_data;
+};
+
+static void emit_link(NetlinkStats *stats, const gchar *name, const struct rtnl_link_stats64 *counters) {
+    stats->link_func(name, strlen(name), counters->rx_bytes, counters->tx_bytes, stats->user_data);
+}
+
+static void set_name(NetlinkStats *stats, int ifindex, const gchar *name, gsize name_len) {
+    const gchar *current = g_hash_table_lookup(stats->names, GINT_TO_POINTER(ifindex));
+
+    if (current && strlen(current) == name_len && memcmp(current, name, name_len) == 0) return;
+    g_hash_table_insert(stats->names, GINT_TO_POINTER(ifindex), g_strndup(name, name_len));
+}
+
+// RTM_NEWLINK, tanto en el volcado inicial como en notificaciones; solo el
+// volcado pedido por nosotros publica contadores
+static void parse_link(NetlinkStats *stats, struct nlmsghdr *nlh, gboolean emit) {
+    struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+    int len = (int)nlh->nlmsg_len - (int)NLMSG_LENGTH(sizeof(*ifi));
+    const gchar *name = NULL;
+    gsize name_len = 0;
+    struct rtnl_link_stats64 counters = { 0 };
+    gboolean have_stats64 = FALSE, have_stats = FALSE;
+
+    if (len < 0) return;
+
+    for (struct rtattr *rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        switch (rta->rta_type) {
+        case IFLA_IFNAME:
+            name = RTA_DATA(rta);
+            name_len = strnlen(name, RTA_PAYLOAD(rta));
+            break;
+        case IFLA_STATS64:
+            // Los atributos solo garantizan alineación a 4 bytes: copiar antes de leer
+            if (RTA_PAYLOAD(rta) >= sizeof(counters)) {
+                memcpy(&counters, RTA_DATA(rta), sizeof(counters));
+                have_stats64 = TRUE;
+            }
+            break;
+        case IFLA_STATS:
+            // Contadores de 32 bits, solo para kernels sin IFLA_STATS64
+            if (!have_stats64 && RTA_PAYLOAD(rta) >= sizeof(struct rtnl_link_stats)) {
+                struct rtnl_link_stats counters32;
+                memcpy(&counters32, RTA_DATA(rta), sizeof(counters32));
+                counters.rx_bytes = counters32.rx_bytes;
+                counters.tx_bytes = counters32.tx_bytes;
+                have_stats = TRUE;
+            }
+            break;
+        }
+    }
+
+    if (!name || name_len == 0) return;
+
+    set_name(stats, ifi->ifi_index, name, name_len);
+
+    if (emit && (have_stats64 || have_stats)) {
+        emit_link(stats, g_hash_table_lookup(stats->names, GINT_TO_POINTER(ifi->ifi_index)), &counters);
+    }
+}
+
+// RTM_NEWSTATS: solo trae el ifindex, el nombre sale de la caché
+static void parse_stats(NetlinkStats *stats, struct nlmsghdr *nlh) {
+    struct if_stats_msg *ifsm = NLMSG_DATA(nlh);
+    int len = (int)nlh->nlmsg_len - (int)NLMSG_LENGTH(sizeof(*ifsm));
+
+    if (len < 0) return;
+
+    const gchar *name = g_hash_table_lookup(stats->names, GINT_TO_POINTER(ifsm->ifindex));
+    if (!name) {
+        // Aparecida entre el volcado y la notificación
+        gchar buffer[IF_NAMESIZE];
+        if (!if_indextoname(ifsm->ifindex, buffer)) return;
+
+        set_name(stats, ifsm->ifindex, buffer, strlen(buffer));
+        name = g_hash_table_lookup(stats->names, GINT_TO_POINTER(ifsm->ifindex));
+    }
+
+    struct rtattr *rta = (struct rtattr *)((guint8 *)ifsm + NLMSG_ALIGN(sizeof(*ifsm)));
+    for (; RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        if (rta->rta_type == IFLA_STATS_LINK_64 && RTA_PAYLOAD(rta) >= sizeof(struct rtnl_link_stats64)) {
+            struct rtnl_link_stats64 counters;
+            memcpy(&counters, RTA_DATA(rta), sizeof(counters));
+            emit_link(stats, name, &counters);
+            return;
+        }
+    }
+}
+
+static void finish_request(NetlinkStats *stats, gboolean success) {
+    stats->in_flight = FALSE;
+    stats->done_func(success, stats->user_data);
+}
+
+static void handle_error(NetlinkStats *stats, struct nlmsghdr *nlh) {
+    const struct nlmsgerr *err = NLMSG_DATA(nlh);
+
+    if (stats->request_type == RTM_GETSTATS) {
+        // Kernel antiguo: seguir siempre con RTM_GETLINK
+        g_debug("RTM_GETSTATS no disponible (%s), se usa RTM_GETLINK", g_strerror(-err->error));
+        stats->use_getstats = FALSE;
+    } else {
+        g_warning("RTM_GETLINK falló: %s", g_strerror(-err->error));
+    }
+
+    finish_request(stats, FALSE);
+}
+
+// Notificaciones de RTMGRP_LINK (seq 0): altas, cambios de nombre y bajas
+static void handle_notification(NetlinkStats *stats, struct nlmsghdr *nlh) {
+    if (nlh->nlmsg_type == RTM_NEWLINK) {
+        parse_link(stats, nlh, FALSE);
+    } else if (nlh->nlmsg_type == RTM_DELLINK) {
+        struct ifinfomsg *ifi = NLMSG_DATA(nlh);
+        g_hash_table_remove(stats->names, GINT_TO_POINTER(ifi->ifi_index));
+    }
+}
+
+// Un mensaje de la respuesta a la petición en curso
+static void handle_reply(NetlinkStats *stats, struct nlmsghdr *nlh) {
+    switch (nlh->nlmsg_type) {
+    case NLMSG_DONE:
+        finish_request(stats, TRUE);
+        break;
+    case NLMSG_ERROR:
+        handle_error(stats, nlh);
+        break;
+    case RTM_NEWLINK:
+        parse_link(stats, nlh, TRUE);
+        break;
+    case RTM_NEWSTATS:
+        parse_stats(stats, nlh);
+        break;
+    }
+}
+
+void netlink_stats_parse_reply(NetlinkStats *stats, const void *data, gsize length) {
+    int len = (int)length;
+
+    for (struct nlmsghdr *nlh = (struct nlmsghdr *)data; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+        handle_reply(stats, nlh);
+    }
+}
+
+static gboolean on_netlink_readable(gint fd, GIOCondition condition G_GNUC_UNUSED, gpointer user_data) {
+    NetlinkStats *stats = user_data;
+
+    for (;;) {
+        ssize_t received = recv(fd, stats->buffer, NETLINK_BUFFER_SIZE, MSG_DONTWAIT);
+
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+
+            // ENOBUFS: se perdieron mensajes (quizá notificaciones), así que se
+            // rehace la caché de nombres con un RTM_GETLINK en la siguiente petición
+            g_debug("Error leyendo del socket netlink: %s", g_strerror(errno));
+            g_hash_table_remove_all(stats->names);
+            if (stats->in_flight) finish_request(stats, FALSE);
+            continue;
+        }
+        if (received == 0) break;
+
+        int len = (int)received;
+        for (struct nlmsghdr *nlh = (struct nlmsghdr *)stats->buffer; NLMSG_OK(nlh, len);
+             nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_seq == 0) {
+                handle_notification(stats, nlh);
+                continue;
+            }
+
+            // Restos de una petición anterior que falló
+            if (!stats->in_flight || nlh->nlmsg_seq != stats->seq) continue;
+
+            handle_reply(stats, nlh);
+        }
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+NetlinkStats *netlink_stats_new(GMainContext *context, NetlinkStatsLinkFunc link_func,
+                                NetlinkStatsDoneFunc done_func, gpointer user_data) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0) {
+        g_warning("No se pudo abrir el socket netlink: %s", g_strerror(errno));
+        return NULL;
+    }
+
+    // Sin las notificaciones los nombres solo se resuelven al ver un ifindex nuevo
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK, .nl_groups = RTMGRP_LINK };
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        g_debug("No se pudo suscribir a RTMGRP_LINK: %s", g_strerror(errno));
+    }
+
+    NetlinkStats *stats = g_malloc0(sizeof(NetlinkStats));
+    stats->fd = fd;
+    stats->use_getstats = TRUE;
+    stats->buffer = g_malloc(NETLINK_BUFFER_SIZE);
+    stats->names = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    stats->link_func = link_func;
+    stats->done_func = done_func;
+    stats->user_data = user_data;
+    stats->watch = g_unix_fd_source_new(fd, G_IO_IN);
+    g_source_set_callback(stats->watch, G_SOURCE_FUNC(on_netlink_readable), stats, NULL);
+    g_source_attach(stats->watch, context);
+
+    return stats;
+}
+
+void netlink_stats_free(NetlinkStats *stats) {
+    if (!stats) return;
+
+    if (stats->watch) {
+        g_source_destroy(stats->watch);
+        g_source_unref(stats->watch);
+        stats->watch = NULL;
+    }
+
+    close(stats->fd);
+    g_hash_table_destroy(stats->names);
+    g_free(stats->buffer);
+    g_free(stats);
+}
+
+gboolean netlink_stats_request(NetlinkStats *stats) {
+    struct {
+        struct nlmsghdr nlh;
+        union {
+            struct ifinfomsg ifi;
+            struct if_stats_msg ifsm;
+        };
+    } request;
+
+    if (stats->in_flight) return FALSE;
+
+    memset(&request, 0, sizeof(request));
+    request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.nlh.nlmsg_seq = ++stats->seq;
+
+    if (stats->use_getstats && g_hash_table_size(stats->names) > 0) {
+        request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct if_stats_msg));
+        request.nlh.nlmsg_type = RTM_GETSTATS;
+        request.ifsm.family = AF_UNSPEC;
+        request.ifsm.filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64);
+    } else {
+        request.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+        request.nlh.nlmsg_type = RTM_GETLINK;
+        request.ifi.ifi_family = AF_UNSPEC;
+    }
+
+    if (send(stats->fd, &request, request.nlh.nlmsg_len, 0) < 0) {
+        g_warning("No se pudo enviar la petición netlink: %s", g_strerror(errno));
+        return FALSE;
+    }
+
+    stats->request_type = request.nlh.nlmsg_type;
+    stats->in_flight = TRUE;
+    return TRUE;
+}
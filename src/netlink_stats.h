@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Contadores de las interfaces de red leídos en binario por rtnetlink en lugar
+// de parsear /proc/net/dev. La petición es asíncrona: la respuesta llega por
+// un watch en `context` (NULL para el contexto por defecto), que llama a
+// `link_func` por cada interfaz y a `done_func` al final.
+typedef struct _NetlinkStats NetlinkStats;
+
+typedef void (*NetlinkStatsLinkFunc)(const gchar *name, gsize name_len,
+                                     guint64 rx_bytes, guint64 tx_bytes, gpointer user_data);
+typedef void (*NetlinkStatsDoneFunc)(gboolean success, gpointer user_data);
+
+// NULL si no se puede abrir el socket
+NetlinkStats *netlink_stats_new(GMainContext *context, NetlinkStatsLinkFunc link_func,
+                                NetlinkStatsDoneFunc done_func, gpointer user_data);
+void netlink_stats_free(NetlinkStats *stats);
+
+// Pedir un volcado de todas las interfaces; FALSE si ya hay uno en curso o falla el envío
+gboolean netlink_stats_request(NetlinkStats *stats);
+
+// Interpretar mensajes de la respuesta a una petición (RTM_NEWLINK,
+// RTM_NEWSTATS, NLMSG_DONE) sin comprobar su número de secuencia. Es lo que
+// hace el watch del socket con cada uno; se expone para medir el parser con
+// volcados sintéticos (tests/bench-proc-parsers.c)
+void netlink_stats_parse_reply(NetlinkStats *stats, const void *data, gsize length);
+
+G_END_DECLS
@@ -8,6 +8,8 @@
 #include "plugins/ram_monitor_widget.h"
 #include "plugins/cpu_monitor_widget.h"
 #include "plugins/net_monitor_widget.h"
+#include "plugins/disk_monitor_widget.h"
+#include "plugins/sensors_widget.h"
 #include "config.h"
 #include <gtk4-layer-shell.h>
 
@@ -28,6 +30,8 @@ struct _PanelWindow {
     GtkWidget *ram_monitor_widget;
     GtkWidget *cpu_monitor_widget;
     GtkWidget *net_monitor_widget;
+    GtkWidget *disk_monitor_widget;
+    GtkWidget *sensors_widget;
     
     GtkWidget *systray_widget;
     GtkWidget *clock_widget;
@@ -149,22 +153,34 @@ static void panel_window_init(PanelWindow *self) {
     
     // Plugin: RAM Monitor - solo si está habilitado
     if (self->config->ram_monitor_enable) {
-        self->ram_monitor_widget = ram_monitor_widget_new();
+        self->ram_monitor_widget = ram_monitor_widget_new(self->config);
         gtk_box_append(self->main_box, self->ram_monitor_widget);
     }
     
     // Plugin: CPU Monitor - solo si está habilitado
     if (self->config->cpu_monitor_enable) {
-        self->cpu_monitor_widget = cpu_monitor_widget_new();
+        self->cpu_monitor_widget = cpu_monitor_widget_new(self->config);
         gtk_box_append(self->main_box, self->cpu_monitor_widget);
     }
     
     // Plugin: Network Monitor - solo si está habilitado
     if (self->config->net_monitor_enable) {
-        self->net_monitor_widget = net_monitor_widget_new();
+        self->net_monitor_widget = net_monitor_widget_new(self->config);
         gtk_box_append(self->main_box, self->net_monitor_widget);
     }
     
+    // Plugin: Disk Monitor - solo si está habilitado
+    if (self->config->disk_monitor_enable) {
+        self->disk_monitor_widget = disk_monitor_widget_new(self->config);
+        gtk_box_append(self->main_box, self->disk_monitor_widget);
+    }
+    
+    // Plugin: Sensores (temperatura, frecuencia, batería) - solo si está habilitado
+    if (self->config->sensors_enable) {
+        self->sensors_widget = sensors_widget_new(self->config);
+        gtk_box_append(self->main_box, self->sensors_widget);
+    }
+    
     // Plugin: Área de Notificación (System Tray) - solo si está habilitado
     if (self->config->systray_enable) {
         self->systray_widget = systray_widget_new(self->config);
@@ -173,7 +189,7 @@ static void panel_window_init(PanelWindow *self) {
     
     // Plugin: Reloj (a la derecha) - solo si está habilitado
     if (self->config->clock_enable) {
-        self->clock_widget = clock_widget_new();
+        self->clock_widget = clock_widget_new(self->config);
         
         // Aplicar configuración del reloj
         panel_window_apply_clock_config(self);
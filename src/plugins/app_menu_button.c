@@ -1,14 +1,81 @@
 #include "app_menu_button.h"
 #include "../config.h"
+#include "../desktop_index_monitor.h"
 #include "../i18n.h"
 #include <gio/gdesktopappinfo.h>
 
+// Alto máximo de un submenú; las categorías más largas se desplazan
+#define CATEGORY_MAX_HEIGHT 480
+
 typedef struct {
-    GtkWidget *popover;
+    GtkWidget *popover;         // categorías de aplicaciones: NULL hasta el primer hover
+    GtkWidget *button;
     GMenu *menu_model;
     const gchar *category_name;
+    GListStore *apps;           // AppMenuItem ordenados por nombre; NULL en Computer
 } CategoryMenu;
 
+// Una aplicación de una categoría. Hay uno por aplicación, pero las filas que
+// los muestran son solo las visibles y se reciclan al desplazar la lista
+#define APP_TYPE_MENU_ITEM (app_menu_item_get_type())
+G_DECLARE_FINAL_TYPE(AppMenuItem, app_menu_item, APP, MENU_ITEM, GObject)
+
+struct _AppMenuItem {
+    GObject parent_instance;
+    gchar *id;
+    gchar *name;
+    gchar *sort_key;            // g_utf8_collate_key() del nombre
+    gchar *icon_str;            // g_icon_to_string() del índice
+    GIcon *icon;                // creado la primera vez que se muestra
+};
+
+G_DEFINE_TYPE(AppMenuItem, app_menu_item, G_TYPE_OBJECT)
+
+static void app_menu_item_finalize(GObject *object) {
+    AppMenuItem *item = APP_MENU_ITEM(object);
+    
+    g_free(item->id);
+    g_free(item->name);
+    g_free(item->sort_key);
+    g_free(item->icon_str);
+    g_clear_object(&item->icon);
+    
+    G_OBJECT_CLASS(app_menu_item_parent_class)->finalize(object);
+}
+
+static void app_menu_item_init(AppMenuItem *item G_GNUC_UNUSED) {
+}
+
+static void app_menu_item_class_init(AppMenuItemClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = app_menu_item_finalize;
+}
+
+static AppMenuItem *app_menu_item_new(const DesktopIndexEntry *entry) {
+    AppMenuItem *item = g_object_new(APP_TYPE_MENU_ITEM, NULL);
+    
+    item->id = g_strdup(entry->id);
+    item->name = g_strdup(entry->name);
+    item->sort_key = g_utf8_collate_key(entry->name, -1);
+    item->icon_str = g_strdup(entry->icon);
+    
+    return item;
+}
+
+static gint compare_menu_items(gconstpointer a, gconstpointer b, gpointer user_data G_GNUC_UNUSED) {
+    return strcmp(((const AppMenuItem *)a)->sort_key, ((const AppMenuItem *)b)->sort_key);
+}
+
+static GIcon *app_menu_item_get_icon(AppMenuItem *item) {
+    if (!item->icon && *item->icon_str) {
+        item->icon = g_icon_new_for_string(item->icon_str, NULL);
+    }
+    if (!item->icon) {
+        item->icon = g_themed_icon_new("application-x-executable");
+    }
+    
+    return item->icon;
+}
+
 struct _AppMenuButton {
     GtkBox parent_instance;
     GtkWidget *menu_button;
@@ -16,23 +83,19 @@ struct _AppMenuButton {
     GSList *category_menus;
     GSimpleActionGroup *action_group;
     PanelConfig *config;
+    
+    // Categorías de aplicaciones, generadas desde el índice compartido; cada
+    // índice nuevo aplica solo las diferencias
+    GtkWidget *categories_box;
+    DesktopIndex *index;
+    DesktopIndexMonitor *index_monitor;
+    gulong index_monitor_handler;
 };
 
 G_DEFINE_TYPE(AppMenuButton, app_menu_button, GTK_TYPE_BOX)
 
-typedef struct {
-    AppMenuButton *menu_button;
-    gchar *app_id;
-} LaunchData;
-
 static void hide_all_category_menus(AppMenuButton *self);
-
-static void launch_data_free(LaunchData *data) {
-    if (data) {
-        g_free(data->app_id);
-        g_free(data);
-    }
-}
+static void on_category_menu_closed(GtkPopover *popover, gpointer user_data);
 
 static void execute_system_command(const gchar *command) {
     if (!command || strlen(command) == 0) return;
@@ -146,13 +209,15 @@ static struct {
 static void hide_all_category_menus(AppMenuButton *self) {
     for (GSList *l = self->category_menus; l != NULL; l = l->next) {
         CategoryMenu *cat_menu = (CategoryMenu *)l->data;
-        gtk_popover_popdown(GTK_POPOVER(cat_menu->popover));
+        if (cat_menu->popover) {
+            gtk_popover_popdown(GTK_POPOVER(cat_menu->popover));
+        }
     }
 }
-static void launch_app_callback(GSimpleAction *action G_GNUC_UNUSED, GVariant *parameter G_GNUC_UNUSED, gpointer user_data) {
-    LaunchData *data = (LaunchData *)user_data;
-    const gchar *app_id = data->app_id;
-    AppMenuButton *self = data->menu_button;
+// Una sola acción app.launch para todas las aplicaciones; el id va como parámetro
+static void launch_app_callback(GSimpleAction *action G_GNUC_UNUSED, GVariant *parameter, gpointer user_data) {
+    const gchar *app_id = g_variant_get_string(parameter, NULL);
+    AppMenuButton *self = APP_MENU_BUTTON(user_data);
     
     GDesktopAppInfo *d_app_info = g_desktop_app_info_new(app_id);
     if (d_app_info) {
@@ -168,6 +233,81 @@ static void launch_app_callback(GSimpleAction *action G_GNUC_UNUSED, GVariant *p
 }
 
 
+// Filas de la lista de aplicaciones: se crean solo las visibles y al
+// desplazar se vuelven a enlazar con otro AppMenuItem
+static void on_app_row_setup(GtkSignalListItemFactory *factory G_GNUC_UNUSED, GtkListItem *list_item,
+                             gpointer user_data G_GNUC_UNUSED) {
+    GtkWidget *row_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+    gtk_widget_add_css_class(row_box, "menu-app-button");
+
+    GtkWidget *icon_widget = gtk_image_new();
+    gtk_image_set_pixel_size(GTK_IMAGE(icon_widget), 16);
+    gtk_box_append(GTK_BOX(row_box), icon_widget);
+
+    GtkWidget *app_label = gtk_label_new(NULL);
+    gtk_label_set_xalign(GTK_LABEL(app_label), 0.0);
+    gtk_box_append(GTK_BOX(row_box), app_label);
+
+    gtk_list_item_set_child(list_item, row_box);
+}
+
+static void on_app_row_bind(GtkSignalListItemFactory *factory G_GNUC_UNUSED, GtkListItem *list_item,
+                            gpointer user_data G_GNUC_UNUSED) {
+    AppMenuItem *item = APP_MENU_ITEM(gtk_list_item_get_item(list_item));
+    GtkWidget *icon_widget = gtk_widget_get_first_child(gtk_list_item_get_child(list_item));
+    GtkWidget *app_label = gtk_widget_get_next_sibling(icon_widget);
+
+    gtk_image_set_from_gicon(GTK_IMAGE(icon_widget), app_menu_item_get_icon(item));
+    gtk_label_set_text(GTK_LABEL(app_label), item->name);
+}
+
+static void on_app_row_activated(GtkListView *list_view, guint position, gpointer user_data G_GNUC_UNUSED) {
+    GListModel *model = G_LIST_MODEL(gtk_list_view_get_model(list_view));
+    AppMenuItem *item = g_list_model_get_item(model, position);
+
+    gtk_widget_activate_action(GTK_WIDGET(list_view), "app.launch", "s", item->id);
+    g_object_unref(item);
+}
+
+// Crear el submenú de una categoría la primera vez que se muestra: hasta
+// entonces solo existe el botón de la categoría. La lista es virtual, así que
+// el coste no depende de cuántas aplicaciones tenga
+static void build_category_popover(AppMenuButton *self, CategoryMenu *cat_menu, GtkWidget *category_button) {
+    gint64 start = g_get_monotonic_time();
+    GtkWidget *category_popover = gtk_popover_new();
+    gtk_widget_set_parent(category_popover, category_button);
+    gtk_popover_set_position(GTK_POPOVER(category_popover), GTK_POS_RIGHT);
+    gtk_popover_set_autohide(GTK_POPOVER(category_popover), FALSE);
+    gtk_popover_set_has_arrow(GTK_POPOVER(category_popover), FALSE);
+    gtk_widget_add_css_class(category_popover, "menu-popover");
+
+    GtkListItemFactory *factory = gtk_signal_list_item_factory_new();
+    g_signal_connect(factory, "setup", G_CALLBACK(on_app_row_setup), NULL);
+    g_signal_connect(factory, "bind", G_CALLBACK(on_app_row_bind), NULL);
+
+    GtkNoSelection *selection = gtk_no_selection_new(G_LIST_MODEL(g_object_ref(cat_menu->apps)));
+    GtkWidget *list_view = gtk_list_view_new(GTK_SELECTION_MODEL(selection), factory);
+    gtk_list_view_set_single_click_activate(GTK_LIST_VIEW(list_view), TRUE);
+    gtk_widget_add_css_class(list_view, "menu-app-list");
+    g_signal_connect(list_view, "activate", G_CALLBACK(on_app_row_activated), self);
+
+    // Alto acotado: sin él la lista mediría todas las filas y las crearía todas
+    GtkWidget *scrolled = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_NEVER, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_propagate_natural_width(GTK_SCROLLED_WINDOW(scrolled), TRUE);
+    gtk_scrolled_window_set_propagate_natural_height(GTK_SCROLLED_WINDOW(scrolled), TRUE);
+    gtk_scrolled_window_set_max_content_height(GTK_SCROLLED_WINDOW(scrolled), CATEGORY_MAX_HEIGHT);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrolled), list_view);
+    gtk_popover_set_child(GTK_POPOVER(category_popover), scrolled);
+
+    g_signal_connect(category_popover, "closed", G_CALLBACK(on_category_menu_closed), self);
+    cat_menu->popover = category_popover;
+
+    g_debug("Submenú %s: %u aplicaciones en %.1f ms", cat_menu->category_name,
+            g_list_model_get_n_items(G_LIST_MODEL(cat_menu->apps)),
+            (g_get_monotonic_time() - start) / 1000.0);
+}
+
 static void show_category_menu(AppMenuButton *self, const gchar *category_name, GtkWidget *relative_widget) {
     // Primero ocultar todos los submenús
     hide_all_category_menus(self);
@@ -176,6 +316,10 @@ static void show_category_menu(AppMenuButton *self, const gchar *category_name,
     for (GSList *l = self->category_menus; l != NULL; l = l->next) {
         CategoryMenu *cat_menu = (CategoryMenu *)l->data;
         if (g_strcmp0(cat_menu->category_name, category_name) == 0) {
+            if (!cat_menu->popover) {
+                build_category_popover(self, cat_menu, relative_widget);
+            }
+            
             // Configurar el popover para que aparezca a la derecha del botón
             gtk_popover_set_position(GTK_POPOVER(cat_menu->popover), GTK_POS_RIGHT);
             
@@ -267,171 +411,262 @@ static void app_menu_button_init(AppMenuButton *self) {
     // Crear grupo de acciones para las aplicaciones
     self->action_group = g_simple_action_group_new();
     gtk_widget_insert_action_group(GTK_WIDGET(self), "app", G_ACTION_GROUP(self->action_group));
+    
+    GSimpleAction *launch_action = g_simple_action_new("launch", G_VARIANT_TYPE_STRING);
+    g_signal_connect(launch_action, "activate", G_CALLBACK(launch_app_callback), self);
+    g_action_map_add_action(G_ACTION_MAP(self->action_group), G_ACTION(launch_action));
+    g_object_unref(launch_action);
     g_object_unref(css_provider);
 }
 
-// 🚀 Construir menú DESPUÉS de establecer config
-static void build_main_menu(AppMenuButton *self) {
-    if (!self->main_menu) return;
-    
-    // Obtener el main_box del popover
-    GtkWidget *main_box = gtk_popover_get_child(GTK_POPOVER(self->main_menu));
-    GHashTable *categories = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
-    
+// Primera categoría del menú que aparece en Categories=, o -1
+static int main_category_for(const gchar *categories) {
+    if (!*categories) return -1;
+
+    gchar **categories_split = g_strsplit(categories, ";", -1);
+    int main_category = -1;
+
+    for (int i = 0; categories_split[i] && main_category < 0; i++) {
+        for (int j = 0; app_categories[j].name; j++) {
+            if (g_strcmp0(categories_split[i], app_categories[j].name) == 0) {
+                main_category = j;
+                break;
+            }
+        }
+    }
+
+    g_strfreev(categories_split);
+    return main_category;
+}
+
+static CategoryMenu *find_category_menu(AppMenuButton *self, const gchar *category_name) {
+    for (GSList *l = self->category_menus; l != NULL; l = l->next) {
+        CategoryMenu *cat_menu = (CategoryMenu *)l->data;
+        if (g_strcmp0(cat_menu->category_name, category_name) == 0) {
+            return cat_menu;
+        }
+    }
+
+    return NULL;
+}
+
+// Crear el botón de una categoría en su sitio según el orden de app_categories;
+// el submenú se crea al mostrarlo (show_category_menu)
+static CategoryMenu *add_category_menu(AppMenuButton *self, int category) {
+    const gchar *category_key = app_categories[category].name;
+
+    // Crear botón de categoría
+    GtkWidget *category_button = gtk_button_new();
+    gtk_button_set_has_frame(GTK_BUTTON(category_button), FALSE);
+    gtk_widget_add_css_class(category_button, "menu-category-button");
+
+    GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+
+    // Icono
+    GtkWidget *icon = gtk_image_new_from_icon_name(app_categories[category].icon);
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), 16);
+    gtk_box_append(GTK_BOX(button_box), icon);
+
+    // Etiqueta (con traducción)
+    GtkWidget *label = gtk_label_new(_(app_categories[category].display_name));
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_box_append(GTK_BOX(button_box), label);
+
+    gtk_button_set_child(GTK_BUTTON(category_button), button_box);
+
+    // Detrás de la categoría anterior que exista, o la primera
+    GtkWidget *previous = NULL;
+    for (int j = category - 1; j >= 0 && !previous; j--) {
+        CategoryMenu *other = find_category_menu(self, app_categories[j].name);
+        previous = other ? other->button : NULL;
+    }
+    gtk_box_insert_child_after(GTK_BOX(self->categories_box), category_button, previous);
+
+    // Almacenar información del submenu
+    CategoryMenu *cat_menu = g_malloc(sizeof(CategoryMenu));
+    cat_menu->popover = NULL;
+    cat_menu->button = category_button;
+    cat_menu->category_name = g_strdup(category_key);
+    cat_menu->menu_model = NULL;
+    cat_menu->apps = g_list_store_new(APP_TYPE_MENU_ITEM);
+    self->category_menus = g_slist_append(self->category_menus, cat_menu);
+
+    // Datos del botón y eventos
+    g_object_set_data_full(G_OBJECT(category_button), "category-name",
+                          g_strdup(category_key), g_free);
+
+    GtkEventController *motion_controller = gtk_event_controller_motion_new();
+    g_signal_connect(motion_controller, "enter", G_CALLBACK(on_category_enter), self);
+    gtk_widget_add_controller(category_button, motion_controller);
+
+    return cat_menu;
+}
+
+static void remove_category_menu(AppMenuButton *self, CategoryMenu *cat_menu) {
+    if (cat_menu->popover) {
+        gtk_widget_unparent(cat_menu->popover);
+    }
+    gtk_box_remove(GTK_BOX(self->categories_box), cat_menu->button);
+    g_object_unref(cat_menu->apps);
+    g_free((gpointer)cat_menu->category_name);
+
+    self->category_menus = g_slist_remove(self->category_menus, cat_menu);
+    g_free(cat_menu);
+}
+
+// Crear las categorías con todas las aplicaciones del índice
+static void populate_app_categories(AppMenuButton *self) {
+    gint64 start = g_get_monotonic_time();
+    guint n_entries = desktop_index_get_n_entries(self->index);
+
     // Recopilar aplicaciones por categoría
-    GList *app_infos = g_app_info_get_all();
-    for (GList *l = app_infos; l != NULL; l = l->next) {
-        GAppInfo *app_info = l->data;
-        if (!G_IS_DESKTOP_APP_INFO(app_info) || !g_app_info_should_show(app_info)) {
-            continue;
+    for (guint e = 0; e < n_entries; e++) {
+        DesktopIndexEntry entry;
+        desktop_index_get_entry(self->index, e, &entry);
+
+        if (!entry.show) continue;
+
+        int main_category = main_category_for(entry.categories);
+        if (main_category < 0 || !*entry.id) continue;
+
+        CategoryMenu *cat_menu = find_category_menu(self, app_categories[main_category].name);
+        if (!cat_menu) {
+            cat_menu = add_category_menu(self, main_category);
         }
-        
-        GDesktopAppInfo *d_app_info = G_DESKTOP_APP_INFO(app_info);
-        const gchar *categories_str = g_desktop_app_info_get_categories(d_app_info);
-        if (!categories_str) continue;
 
-        gchar **categories_split = g_strsplit(categories_str, ";", -1);
-        if (!categories_split || !categories_split[0] || categories_split[0][0] == '\0') {
-            g_strfreev(categories_split);
-            continue;
+        AppMenuItem *item = app_menu_item_new(&entry);
+        g_list_store_append(cat_menu->apps, item);
+        g_object_unref(item);
+    }
+
+    for (GSList *l = self->category_menus; l != NULL; l = l->next) {
+        CategoryMenu *cat_menu = (CategoryMenu *)l->data;
+        if (cat_menu->apps) {
+            g_list_store_sort(cat_menu->apps, compare_menu_items, NULL);
         }
+    }
 
-        // Buscar la primera categoría que coincida
-        const gchar *main_category = NULL;
-        for (int i = 0; categories_split[i]; i++) {
-            for (int j = 0; app_categories[j].name; j++) {
-                if (g_strcmp0(categories_split[i], app_categories[j].name) == 0) {
-                    main_category = app_categories[j].name;
-                    break;
-                }
-            }
-            if (main_category) break;
+    g_debug("Menú de aplicaciones: %u entradas en %.1f ms", n_entries,
+            (g_get_monotonic_time() - start) / 1000.0);
+}
+
+static gboolean find_menu_item(GListStore *apps, const gchar *app_id, guint *position) {
+    guint n_items = g_list_model_get_n_items(G_LIST_MODEL(apps));
+
+    for (guint i = 0; i < n_items; i++) {
+        AppMenuItem *item = g_list_model_get_item(G_LIST_MODEL(apps), i);
+        gboolean found = strcmp(item->id, app_id) == 0;
+        g_object_unref(item);
+
+        if (found) {
+            *position = i;
+            return TRUE;
         }
+    }
 
-        if (main_category) {
-            // Obtener o crear lista de apps para la categoría
-            GList *app_list = g_hash_table_lookup(categories, main_category);
-            app_list = g_list_append(app_list, g_object_ref(app_info));
-            g_hash_table_replace(categories, g_strdup(main_category), app_list);
+    return FALSE;
+}
+
+// Aplicar solo los cambios entre dos índices: las categorías no afectadas
+// conservan su modelo y su submenú, y las listas abiertas solo ven las filas que cambian
+static void apply_index_diff(AppMenuButton *self, DesktopIndex *previous, DesktopIndexDiff *diff) {
+    for (guint i = 0; i < diff->removed->len; i++) {
+        DesktopIndexEntry entry;
+        desktop_index_get_entry(previous, g_array_index(diff->removed, guint, i), &entry);
+
+        int main_category = main_category_for(entry.categories);
+        if (main_category < 0) continue;
+
+        CategoryMenu *cat_menu = find_category_menu(self, app_categories[main_category].name);
+        guint position;
+        if (!cat_menu || !find_menu_item(cat_menu->apps, entry.id, &position)) continue;
+
+        g_list_store_remove(cat_menu->apps, position);
+        if (g_list_model_get_n_items(G_LIST_MODEL(cat_menu->apps)) == 0) {
+            remove_category_menu(self, cat_menu);
         }
+    }
+
+    for (guint i = 0; i < diff->added->len; i++) {
+        DesktopIndexEntry entry;
+        desktop_index_get_entry(self->index, g_array_index(diff->added, guint, i), &entry);
+
+        if (!entry.show) continue;
 
-        g_strfreev(categories_split);
+        int main_category = main_category_for(entry.categories);
+        if (main_category < 0 || !*entry.id) continue;
+
+        CategoryMenu *cat_menu = find_category_menu(self, app_categories[main_category].name);
+        if (!cat_menu) {
+            cat_menu = add_category_menu(self, main_category);
+        }
+
+        AppMenuItem *item = app_menu_item_new(&entry);
+        g_list_store_insert_sorted(cat_menu->apps, item, compare_menu_items, NULL);
+        g_object_unref(item);
     }
-    
-    // Crear botones de categoría
-    for (int i = 0; app_categories[i].name; i++) {
-        const gchar *category_key = app_categories[i].name;
-        GList *app_list = g_hash_table_lookup(categories, category_key);
-        
-        if (!app_list) continue; // Solo mostrar categorías con aplicaciones
-        
-        // Crear botón de categoría
-        GtkWidget *category_button = gtk_button_new();
-        gtk_button_set_has_frame(GTK_BUTTON(category_button), FALSE);
-        gtk_widget_add_css_class(category_button, "menu-category-button");
-        
-        GtkWidget *button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
-        
-        // Icono
-        GtkWidget *icon = gtk_image_new_from_icon_name(app_categories[i].icon);
-        gtk_image_set_pixel_size(GTK_IMAGE(icon), 16);
-        gtk_box_append(GTK_BOX(button_box), icon);
-        
-        // Etiqueta (con traducción)
-        GtkWidget *label = gtk_label_new(_(app_categories[i].display_name));
-        gtk_label_set_xalign(GTK_LABEL(label), 0.0);
-        gtk_box_append(GTK_BOX(button_box), label);
-        
-        gtk_button_set_child(GTK_BUTTON(category_button), button_box);
-        gtk_box_append(GTK_BOX(main_box), category_button);
-        
-        // Crear popover para esta categoría
-        GtkWidget *category_popover = gtk_popover_new();
-        gtk_widget_set_parent(category_popover, category_button);
-        gtk_popover_set_position(GTK_POPOVER(category_popover), GTK_POS_RIGHT);
-        gtk_popover_set_autohide(GTK_POPOVER(category_popover), FALSE);
-        gtk_popover_set_has_arrow(GTK_POPOVER(category_popover), FALSE);
-        gtk_widget_add_css_class(category_popover, "menu-popover");
-        
-        GtkWidget *category_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
-        gtk_popover_set_child(GTK_POPOVER(category_popover), category_box);
-        
-        // Añadir aplicaciones
-        for (GList *app_iter = app_list; app_iter != NULL; app_iter = app_iter->next) {
-            GAppInfo *app_info = G_APP_INFO(app_iter->data);
-            const gchar *app_id = g_app_info_get_id(app_info);
-            if (!app_id) continue;
-            
-            // Crear botón de aplicación
-            GtkWidget *app_button = gtk_button_new();
-            gtk_button_set_has_frame(GTK_BUTTON(app_button), FALSE);
-            gtk_widget_add_css_class(app_button, "menu-app-button");
-            
-            GtkWidget *app_button_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
-            
-            // Icono de la aplicación
-            GIcon *app_icon = g_app_info_get_icon(app_info);
-            GtkWidget *icon_widget = app_icon ? 
-                gtk_image_new_from_gicon(app_icon) : 
-                gtk_image_new_from_icon_name("application-x-executable");
-            gtk_image_set_pixel_size(GTK_IMAGE(icon_widget), 16);
-            gtk_box_append(GTK_BOX(app_button_box), icon_widget);
-            
-            // Etiqueta de la aplicación
-            GtkWidget *app_label = gtk_label_new(g_app_info_get_display_name(app_info));
-            gtk_label_set_xalign(GTK_LABEL(app_label), 0.0);
-            gtk_box_append(GTK_BOX(app_button_box), app_label);
-            
-            gtk_button_set_child(GTK_BUTTON(app_button), app_button_box);
-            gtk_box_append(GTK_BOX(category_box), app_button);
-            
-            // Crear acción para lanzar aplicación
-            LaunchData *launch_data = g_malloc(sizeof(LaunchData));
-            launch_data->menu_button = self;
-            launch_data->app_id = g_strdup(app_id);
-            
-            gchar *action_name = g_strdup_printf("launch-app-%s", app_id);
-            // Limpiar caracteres especiales
-            for (gchar *p = action_name; *p; p++) {
-                if (!g_ascii_isalnum(*p) && *p != '-') *p = '-';
-            }
-            
-            GSimpleAction *action = g_simple_action_new(action_name, NULL);
-            g_signal_connect(action, "activate", G_CALLBACK(launch_app_callback), launch_data);
-            g_action_map_add_action(G_ACTION_MAP(self->action_group), G_ACTION(action));
-            
-            g_object_set_data_full(G_OBJECT(action), "launch-data", launch_data, 
-                                  (GDestroyNotify)launch_data_free);
-            
-            gchar *full_action_name = g_strdup_printf("app.%s", action_name);
-            gtk_actionable_set_action_name(GTK_ACTIONABLE(app_button), full_action_name);
-            
-            g_free(action_name);
-            g_free(full_action_name);
-            g_object_unref(action);
+
+    if (diff->removed->len > 0 || diff->added->len > 0) {
+        g_debug("Menú de aplicaciones: %u entradas quitadas, %u añadidas",
+                diff->removed->len, diff->added->len);
+    }
+}
+
+// Quitar todas las categorías de aplicaciones (Computer no tiene modelo y se queda)
+static void clear_app_categories(AppMenuButton *self) {
+    GSList *l = self->category_menus;
+
+    while (l != NULL) {
+        CategoryMenu *cat_menu = (CategoryMenu *)l->data;
+        l = l->next;
+
+        if (cat_menu->apps) {
+            remove_category_menu(self, cat_menu);
         }
-        
-        // Almacenar información del submenu
-        CategoryMenu *cat_menu = g_malloc(sizeof(CategoryMenu));
-        cat_menu->popover = category_popover;
-        cat_menu->category_name = g_strdup(category_key);
-        cat_menu->menu_model = NULL;
-        self->category_menus = g_slist_append(self->category_menus, cat_menu);
-        
-        // Datos del botón y eventos
-        g_object_set_data_full(G_OBJECT(category_button), "category-name", 
-                              g_strdup(category_key), g_free);
-        
-        GtkEventController *motion_controller = gtk_event_controller_motion_new();
-        g_signal_connect(motion_controller, "enter", G_CALLBACK(on_category_enter), self);
-        gtk_widget_add_controller(category_button, motion_controller);
-        
-        g_signal_connect(category_popover, "closed", G_CALLBACK(on_category_menu_closed), self);
     }
-    
-    // Limpieza
-    g_list_free_full(app_infos, g_object_unref);
-    g_hash_table_destroy(categories);
+}
+
+// El monitor tiene un índice nuevo. El diff se calculó contra `previous`: solo
+// sirve si es el índice que tiene el menú; si no (o es el primero), se rehace entero
+static void on_index_changed(DesktopIndexMonitor *monitor, DesktopIndex *previous,
+                             DesktopIndexDiff *diff, gpointer user_data) {
+    AppMenuButton *self = APP_MENU_BUTTON(user_data);
+    DesktopIndex *old_index = self->index;
+
+    self->index = desktop_index_ref(desktop_index_monitor_get_index(monitor));
+
+    if (old_index && old_index == previous && diff) {
+        apply_index_diff(self, previous, diff);
+    } else {
+        clear_app_categories(self);
+        populate_app_categories(self);
+    }
+
+    if (old_index) {
+        desktop_index_unref(old_index);
+    }
+}
+
+// 🚀 Construir menú DESPUÉS de establecer config
+static void build_main_menu(AppMenuButton *self) {
+    if (!self->main_menu) return;
+
+    // Obtener el main_box del popover
+    GtkWidget *main_box = gtk_popover_get_child(GTK_POPOVER(self->main_menu));
+
+    // Las categorías de aplicaciones van en su propia caja para poder rehacerlas
+    self->categories_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+    gtk_box_append(GTK_BOX(main_box), self->categories_box);
+
+    // Si el primer índice aún se está construyendo, llega con "changed"
+    self->index_monitor = g_object_ref(desktop_index_monitor_get_default());
+    DesktopIndex *index = desktop_index_monitor_get_index(self->index_monitor);
+    if (index) {
+        self->index = desktop_index_ref(index);
+        populate_app_categories(self);
+    }
+    self->index_monitor_handler = g_signal_connect(self->index_monitor, "changed",
+                                                   G_CALLBACK(on_index_changed), self);
 
     // Añadir al FINAL del menú
     GtkWidget *separator = gtk_separator_new(GTK_ORIENTATION_HORIZONTAL);
@@ -465,8 +700,10 @@ static void build_main_menu(AppMenuButton *self) {
         // Añadir a la lista de menús de categorías
         CategoryMenu *computer_cat_menu = g_malloc(sizeof(CategoryMenu));
         computer_cat_menu->popover = computer_menu;
+        computer_cat_menu->button = computer_button;
         computer_cat_menu->category_name = g_strdup("Computer");
         computer_cat_menu->menu_model = NULL;
+        computer_cat_menu->apps = NULL;
         self->category_menus = g_slist_append(self->category_menus, computer_cat_menu);
         
         // CRÍTICO: Datos del botón con g_strdup para consistencia
@@ -490,12 +727,25 @@ static void build_main_menu(AppMenuButton *self) {
 static void app_menu_button_dispose(GObject *object) {
     AppMenuButton *self = APP_MENU_BUTTON(object);
     
+    if (self->index_monitor) {
+        g_signal_handler_disconnect(self->index_monitor, self->index_monitor_handler);
+        g_clear_object(&self->index_monitor);
+    }
+    
+    if (self->index) {
+        desktop_index_unref(self->index);
+        self->index = NULL;
+    }
+    
     // Limpiar menús de categoría
     for (GSList *l = self->category_menus; l != NULL; l = l->next) {
         CategoryMenu *cat_menu = (CategoryMenu *)l->data;
         if (cat_menu->popover) {
             gtk_widget_unparent(cat_menu->popover);
         }
+        if (cat_menu->apps) {
+            g_object_unref(cat_menu->apps);
+        }
         g_free((gpointer)cat_menu->category_name);
         g_free(cat_menu);
     }
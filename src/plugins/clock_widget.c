@@ -1,5 +1,6 @@
 #include "clock_widget.h"
 #include "../i18n.h"
+#include "../timebase.h"
 #include <time.h>
 
 struct _ClockWidget {
@@ -7,27 +8,51 @@ struct _ClockWidget {
     GtkWidget *clock_button;
     GtkWidget *clock_label;
     GtkWidget *calendar_popover;
+    PanelConfig *config;
     guint timeout_id;
+    
+    // Último texto mostrado, para no tocar el label si no cambia
+    gchar time_text[80];
+    gchar date_text[80];
 };
 
 G_DEFINE_TYPE(ClockWidget, clock_widget, GTK_TYPE_BOX)
 
+// ¿Muestra el formato segundos? (%S, %T, %r, %X, %c, %s, con o sin modificador E/O)
+static gboolean format_has_seconds(const gchar *format) {
+    for (const gchar *p = strchr(format, '%'); p; p = strchr(p, '%')) {
+        p++;
+        while (*p == 'E' || *p == 'O' || *p == '-' || *p == '_' || *p == '0' || *p == '^' || *p == '#') p++;
+        if (*p && strchr("STrXcs", *p)) return TRUE;
+        if (*p) p++;
+    }
+    return FALSE;
+}
+
 static void update_clock_display(ClockWidget *self) {
     time_t rawtime;
-    struct tm *timeinfo;
+    struct tm timeinfo;
     char time_buffer[80];
     char date_buffer[80];
     
     time(&rawtime);
-    timeinfo = localtime(&rawtime);
+    localtime_r(&rawtime, &timeinfo);
     
-    // Formato para el label: solo HH:MM
-    strftime(time_buffer, sizeof(time_buffer), "%H:%M", timeinfo);
-    gtk_label_set_text(GTK_LABEL(self->clock_label), time_buffer);
+    // Formato para el label (por defecto solo HH:MM)
+    if (strftime(time_buffer, sizeof(time_buffer), self->config->clock_format, &timeinfo) == 0) {
+        time_buffer[0] = '\0';
+    }
+    if (strcmp(time_buffer, self->time_text) != 0) {
+        g_strlcpy(self->time_text, time_buffer, sizeof(self->time_text));
+        gtk_label_set_text(GTK_LABEL(self->clock_label), time_buffer);
+    }
     
-    // Formato para el tooltip: fecha completa
-    strftime(date_buffer, sizeof(date_buffer), "%A, %d %B %Y", timeinfo);
-    gtk_widget_set_tooltip_text(self->clock_button, date_buffer);
+    // Formato para el tooltip: fecha completa (cambia una vez al día)
+    strftime(date_buffer, sizeof(date_buffer), "%A, %d %B %Y", &timeinfo);
+    if (strcmp(date_buffer, self->date_text) != 0) {
+        g_strlcpy(self->date_text, date_buffer, sizeof(self->date_text));
+        gtk_widget_set_tooltip_text(self->clock_button, date_buffer);
+    }
 }
 
 static gboolean on_clock_timeout(gpointer user_data) {
@@ -84,14 +109,20 @@ static void clock_widget_init(ClockWidget *self) {
     // Conectar señales
     g_signal_connect(self->clock_button, "clicked", G_CALLBACK(on_clock_button_clicked), self);
     
+    // Limpiar CSS provider
+    g_object_unref(css_provider);
+}
+
+// Iniciar el reloj DESPUÉS de establecer config
+static void clock_widget_start(ClockWidget *self) {
     // Actualizar reloj inmediatamente
     update_clock_display(self);
     
-    // Iniciar timer para actualizar cada segundo
-    self->timeout_id = g_timeout_add_seconds(1, on_clock_timeout, self);
-    
-    // Limpiar CSS provider
-    g_object_unref(css_provider);
+    // Despertar al cambiar el minuto, o cada segundo si el formato los muestra;
+    // un retraso de unas décimas no se nota y deja agrupar el despertar
+    gboolean has_seconds = format_has_seconds(self->config->clock_format);
+    self->timeout_id = timebase_add(has_seconds ? 1000 : 60000, has_seconds ? 50 : 500,
+                                    on_clock_timeout, self);
 }
 
 static void clock_widget_dispose(GObject *object) {
@@ -99,7 +130,7 @@ static void clock_widget_dispose(GObject *object) {
     
     // Detener el timeout
     if (self->timeout_id > 0) {
-        g_source_remove(self->timeout_id);
+        timebase_remove(self->timeout_id);
         self->timeout_id = 0;
     }
     
@@ -117,6 +148,9 @@ static void clock_widget_class_init(ClockWidgetClass *klass) {
     object_class->dispose = clock_widget_dispose;
 }
 
-GtkWidget *clock_widget_new(void) {
-    return g_object_new(CLOCK_TYPE_WIDGET, NULL);
+GtkWidget *clock_widget_new(PanelConfig *config) {
+    ClockWidget *self = g_object_new(CLOCK_TYPE_WIDGET, NULL);
+    self->config = config;
+    clock_widget_start(self);
+    return GTK_WIDGET(self);
 }
@@ -2,13 +2,14 @@
 #define CLOCK_WIDGET_H
 
 #include <gtk/gtk.h>
+#include "../config.h"
 
 G_BEGIN_DECLS
 
 #define CLOCK_TYPE_WIDGET (clock_widget_get_type())
 G_DECLARE_FINAL_TYPE(ClockWidget, clock_widget, CLOCK, WIDGET, GtkBox)
 
-GtkWidget *clock_widget_new(void);
+GtkWidget *clock_widget_new(PanelConfig *config);
 
 G_END_DECLS
 
@@ -1,127 +1,176 @@
 #include "cpu_monitor_widget.h"
 #include "../i18n.h"
-#include <stdio.h>
-
-#define HISTORY_SIZE 30
+#include "../system_monitor.h"
+#include "../monitor_graph.h"
+#include "../monitor_activity.h"
+#include "../process_popover.h"
+#include <math.h>
 
 struct _CpuMonitorWidget {
     GtkBox parent_instance;
     
     GtkWidget *drawing_area;
-    guint timeout_id;
+    PanelConfig *config;
     
-    // Historial de CPU para gráfica
-    double cpu_history[HISTORY_SIZE];
-    int history_index;
+    // Muestreador compartido
+    SystemMonitor *monitor;
+    SystemMonitorSource source;
+    gulong updated_handler;
+    MonitorActivity *activity;
+    
+    // Procesos que más CPU usan, al hacer clic
+    GtkWidget *process_popover;
     
-    // Datos CPU anteriores para cálculo
-    gulong prev_total;
-    gulong prev_idle;
+    // Modo por núcleo: mapa de calor en lugar de historial
+    gboolean per_core;
+    
+    // Historial de CPU para gráfica
+    MonitorGraph *graph;
     
     double current_cpu_percent;
 };
 
 G_DEFINE_TYPE(CpuMonitorWidget, cpu_monitor_widget, GTK_TYPE_BOX)
 
-static void read_cpu_info(CpuMonitorWidget *self) {
-    FILE *file = fopen("/proc/stat", "r");
-    if (!file) return;
+static void update_tooltip(CpuMonitorWidget *self) {
+    gchar *tooltip;
     
-    gulong user, nice, system, idle, iowait, irq, softirq, steal;
-    if (fscanf(file, "cpu %lu %lu %lu %lu %lu %lu %lu %lu", 
-               &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) == 8) {
-        
-        gulong total = user + nice + system + idle + iowait + irq + softirq + steal;
-        gulong idle_total = idle + iowait;
-        
-        if (self->prev_total > 0) {
-            gulong total_diff = total - self->prev_total;
-            gulong idle_diff = idle_total - self->prev_idle;
-            
-            if (total_diff > 0) {
-                self->current_cpu_percent = ((double)(total_diff - idle_diff) / total_diff) * 100.0;
-                if (self->current_cpu_percent < 0) self->current_cpu_percent = 0;
-                if (self->current_cpu_percent > 100) self->current_cpu_percent = 100;
-            }
+    if (self->per_core) {
+        const SystemMonitorCpu *cpu = &system_monitor_get_snapshot(self->monitor)->cpu;
+        guint busiest = 0;
+        for (guint i = 1; i < cpu->n_cores; i++) {
+            if (cpu->core_usage[i] > cpu->core_usage[busiest]) busiest = i;
         }
         
-        self->prev_total = total;
-        self->prev_idle = idle_total;
+        tooltip = g_strdup_printf(_("CPU: %.1f%% (%u cores)\n"
+                                  "Busiest: cpu%u %.1f%%"),
+                                  self->current_cpu_percent, cpu->n_cores,
+                                  busiest, cpu->n_cores ? cpu->core_usage[busiest] : 0.0f);
+    } else {
+        tooltip = g_strdup_printf("CPU: %.1f%%", self->current_cpu_percent);
     }
-    fclose(file);
-}
-
-static void update_tooltip(CpuMonitorWidget *self) {
-    gchar *tooltip = g_strdup_printf("CPU: %.1f%%", self->current_cpu_percent);
+    
     gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip);
     g_free(tooltip);
 }
 
-static void draw_cpu_graph(GtkDrawingArea *area G_GNUC_UNUSED, cairo_t *cr, 
-                          int width, int height, gpointer user_data) {
-    CpuMonitorWidget *self = CPU_MONITOR_WIDGET(user_data);
+// Un rectángulo por núcleo: barras si caben, si no una rejilla a modo de mapa de calor
+static void draw_cpu_cores(CpuMonitorWidget *self, cairo_t *cr, int width, int height) {
+    const SystemMonitorCpu *cpu = &system_monitor_get_snapshot(self->monitor)->cpu;
+    guint n_cores = cpu->n_cores;
     
-    // Fondo
-    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.3);
-    cairo_rectangle(cr, 0, 0, width, height);
-    cairo_fill(cr);
+    if (n_cores == 0) return;
     
-    // Líneas de la gráfica
-    cairo_set_line_width(cr, 1.0);
-    cairo_set_source_rgba(cr, 0.0, 0.47, 0.84, 1.0); // Azul
+    if ((guint)width >= n_cores * 2) {
+        double bar_width = (double)width / n_cores;
+        
+        cairo_set_source_rgba(cr, 0.0, 0.47, 0.84, 1.0); // Azul
+        for (guint i = 0; i < n_cores; i++) {
+            double bar_height = cpu->core_usage[i] / 100.0 * height;
+            cairo_rectangle(cr, i * bar_width, height - bar_height,
+                            MAX(bar_width - 1.0, 1.0), bar_height);
+        }
+        cairo_fill(cr);
+        return;
+    }
     
-    double x_step = (double)width / (HISTORY_SIZE - 1);
+    guint columns = (guint)ceil(sqrt((double)n_cores * width / MAX(height, 1)));
+    columns = CLAMP(columns, 1, n_cores);
+    guint rows = (n_cores + columns - 1) / columns;
+    double cell_width = (double)width / columns;
+    double cell_height = (double)height / rows;
+    
+    for (guint i = 0; i < n_cores; i++) {
+        // De azul (libre) a rojo (saturado)
+        double load = cpu->core_usage[i] / 100.0;
+        cairo_set_source_rgba(cr, load, 0.47 * (1.0 - load), 0.84 * (1.0 - load), 0.3 + 0.7 * load);
+        cairo_rectangle(cr, (i % columns) * cell_width, (i / columns) * cell_height,
+                        cell_width, cell_height);
+        cairo_fill(cr);
+    }
+}
+
+static void draw_cpu_graph(GtkDrawingArea *area, cairo_t *cr, 
+                          int width, int height, gpointer user_data) {
+    CpuMonitorWidget *self = CPU_MONITOR_WIDGET(user_data);
     
-    for (int i = 0; i < HISTORY_SIZE - 1; i++) {
-        int idx1 = (self->history_index + i) % HISTORY_SIZE;
-        int idx2 = (self->history_index + i + 1) % HISTORY_SIZE;
-        
-        double x1 = i * x_step;
-        double x2 = (i + 1) * x_step;
-        double y1 = height - (self->cpu_history[idx1] / 100.0) * height;
-        double y2 = height - (self->cpu_history[idx2] / 100.0) * height;
+    if (self->activity) {
+        monitor_activity_drawn(self->activity);
+    }
+    
+    if (self->per_core) {
+        // Fondo
+        cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.3);
+        cairo_rectangle(cr, 0, 0, width, height);
+        cairo_fill(cr);
         
-        cairo_move_to(cr, x1, y1);
-        cairo_line_to(cr, x2, y2);
-        cairo_stroke(cr);
+        draw_cpu_cores(self, cr, width, height);
+        return;
+    }
+    
+    if (self->graph) {
+        monitor_graph_draw(self->graph, cr, width, height,
+                           gtk_widget_get_scale_factor(GTK_WIDGET(area)));
     }
 }
 
-static gboolean on_update_cpu(gpointer user_data) {
+static void on_monitor_updated(SystemMonitor *monitor, guint sources, gpointer user_data) {
     CpuMonitorWidget *self = CPU_MONITOR_WIDGET(user_data);
     
-    read_cpu_info(self);
+    if (!(sources & self->source)) return;
+    
+    self->current_cpu_percent = system_monitor_get_snapshot(monitor)->cpu.usage_percent;
     
-    // Actualizar historial
-    self->cpu_history[self->history_index] = self->current_cpu_percent;
-    self->history_index = (self->history_index + 1) % HISTORY_SIZE;
+    // Actualizar historial (una muestra por intervalo base aunque se haya muestreado menos)
+    monitor_graph_push_repeat(self->graph, &self->current_cpu_percent,
+                              system_monitor_get_periods(monitor, self->source));
     
     update_tooltip(self);
     
     // Redibujar
-    gtk_widget_queue_draw(self->drawing_area);
+    monitor_activity_queue_draw(self->activity, self->drawing_area);
+}
+
+static void on_widget_pressed(GtkGestureClick *gesture G_GNUC_UNUSED, gint n_press G_GNUC_UNUSED,
+                              gdouble x G_GNUC_UNUSED, gdouble y G_GNUC_UNUSED, gpointer user_data) {
+    CpuMonitorWidget *self = CPU_MONITOR_WIDGET(user_data);
     
-    return G_SOURCE_CONTINUE;
+    if (gtk_widget_get_visible(self->process_popover)) {
+        gtk_popover_popdown(GTK_POPOVER(self->process_popover));
+    } else {
+        monitor_activity_boost(self->activity);
+        gtk_popover_popup(GTK_POPOVER(self->process_popover));
+    }
 }
 
 static void cpu_monitor_widget_dispose(GObject *object) {
     CpuMonitorWidget *self = CPU_MONITOR_WIDGET(object);
     
-    if (self->timeout_id > 0) {
-        g_source_remove(self->timeout_id);
-        self->timeout_id = 0;
+    if (self->process_popover) {
+        gtk_widget_unparent(self->process_popover);
+        self->process_popover = NULL;
+    }
+    
+    if (self->activity) {
+        monitor_activity_free(self->activity);
+        self->activity = NULL;
+    }
+    
+    if (self->monitor) {
+        g_signal_handler_disconnect(self->monitor, self->updated_handler);
+        system_monitor_unsubscribe(self->monitor, self->source);
+        self->monitor = NULL;
+    }
+    
+    if (self->graph) {
+        monitor_graph_free(self->graph);
+        self->graph = NULL;
     }
     
     G_OBJECT_CLASS(cpu_monitor_widget_parent_class)->dispose(object);
 }
 
 static void cpu_monitor_widget_init(CpuMonitorWidget *self) {
-    // Inicializar historial
-    for (int i = 0; i < HISTORY_SIZE; i++) {
-        self->cpu_history[i] = 0.0;
-    }
-    self->history_index = 0;
-    
     // Crear drawing area para la gráfica
     self->drawing_area = gtk_drawing_area_new();
     gtk_widget_add_css_class(self->drawing_area, "cpu-monitor-graph");
@@ -129,6 +178,13 @@ static void cpu_monitor_widget_init(CpuMonitorWidget *self) {
                                    draw_cpu_graph, self, NULL);
     gtk_box_append(GTK_BOX(self), self->drawing_area);
     
+    self->process_popover = process_popover_new(PROCESS_SORT_CPU);
+    gtk_widget_set_parent(self->process_popover, GTK_WIDGET(self));
+    
+    GtkGesture *click = gtk_gesture_click_new();
+    g_signal_connect(click, "pressed", G_CALLBACK(on_widget_pressed), self);
+    gtk_widget_add_controller(GTK_WIDGET(self), GTK_EVENT_CONTROLLER(click));
+    
     // Cargar CSS desde GResource
     static gboolean styles_applied = FALSE;
     if (!styles_applied) {
@@ -142,12 +198,23 @@ static void cpu_monitor_widget_init(CpuMonitorWidget *self) {
         g_object_unref(css_provider);
         styles_applied = TRUE;
     }
-    
-    // Primera lectura para inicializar
-    read_cpu_info(self);
-    
-    // Timer cada segundo
-    self->timeout_id = g_timeout_add_seconds(1, on_update_cpu, self);
+}
+
+// Suscribirse al muestreador DESPUÉS de establecer config
+static void cpu_monitor_widget_start(CpuMonitorWidget *self) {
+    self->per_core = g_strcmp0(self->config->cpu_monitor_mode, "per-core") == 0;
+    self->source = self->per_core ? SYSTEM_MONITOR_CPU_CORES : SYSTEM_MONITOR_CPU;
+    
+    // Historial de porcentajes: escala lineal sobre [0, 100]
+    self->graph = monitor_graph_new(1, self->config->cpu_monitor_history, MONITOR_RING_LINEAR, 100.0);
+    monitor_graph_set_color(self->graph, 0, 0.0, 0.47, 0.84); // Azul
+    monitor_graph_set_scrolling(self->graph, self->config->cpu_monitor_scrolling);
+    
+    self->monitor = system_monitor_get_default();
+    self->updated_handler = g_signal_connect(self->monitor, "updated",
+                                             G_CALLBACK(on_monitor_updated), self);
+    system_monitor_subscribe(self->monitor, self->source, self->config->cpu_monitor_interval_ms);
+    self->activity = monitor_activity_new(GTK_WIDGET(self), self->monitor, self->source);
 }
 
 static void cpu_monitor_widget_class_init(CpuMonitorWidgetClass *klass) {
@@ -155,6 +222,9 @@ static void cpu_monitor_widget_class_init(CpuMonitorWidgetClass *klass) {
     object_class->dispose = cpu_monitor_widget_dispose;
 }
 
-GtkWidget *cpu_monitor_widget_new(void) {
-    return g_object_new(CPU_TYPE_MONITOR_WIDGET, NULL);
+GtkWidget *cpu_monitor_widget_new(PanelConfig *config) {
+    CpuMonitorWidget *self = g_object_new(CPU_TYPE_MONITOR_WIDGET, NULL);
+    self->config = config;
+    cpu_monitor_widget_start(self);
+    return GTK_WIDGET(self);
 }
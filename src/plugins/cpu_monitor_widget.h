@@ -1,12 +1,13 @@
 #pragma once
 
 #include <gtk/gtk.h>
+#include "../config.h"
 
 G_BEGIN_DECLS
 
 #define CPU_TYPE_MONITOR_WIDGET (cpu_monitor_widget_get_type())
 G_DECLARE_FINAL_TYPE(CpuMonitorWidget, cpu_monitor_widget, CPU, MONITOR_WIDGET, GtkBox)
 
-GtkWidget *cpu_monitor_widget_new(void);
+GtkWidget *cpu_monitor_widget_new(PanelConfig *config);
 
 G_END_DECLS
@@ -0,0 +1,198 @@
+#include "disk_monitor_widget.h"
+#include "../i18n.h"
+#include "../system_monitor.h"
+#include "../monitor_graph.h"
+#include "../monitor_activity.h"
+
+// Un dispositivo ocupado más de este % del tiempo está saturado: las
+// peticiones hacen cola y el sistema "va lento" aunque la CPU esté libre
+#define DISK_SATURATED_PERCENT 90.0
+
+struct _DiskMonitorWidget {
+    GtkBox parent_instance;
+    
+    GtkWidget *drawing_area;
+    PanelConfig *config;
+    
+    // Muestreador compartido
+    SystemMonitor *monitor;
+    gulong updated_handler;
+    MonitorActivity *activity;
+    
+    // Historial de throughput (serie 0: lectura, serie 1: escritura)
+    MonitorGraph *graph;
+    
+    double max_speed;
+};
+
+G_DEFINE_TYPE(DiskMonitorWidget, disk_monitor_widget, GTK_TYPE_BOX)
+
+static void update_tooltip(DiskMonitorWidget *self, const SystemMonitorDisk *disk) {
+    double read_display = disk->read_speed;
+    double write_display = disk->write_speed;
+    const gchar *read_unit = system_monitor_scale_speed(&read_display);
+    const gchar *write_unit = system_monitor_scale_speed(&write_display);
+    
+    GString *tooltip = g_string_new(NULL);
+    g_string_printf(tooltip,
+        _("Disk:\n"
+        "Read: %.1f %s (%.0f IOPS)\n"
+        "Write: %.1f %s (%.0f IOPS)\n"
+        "Busy: %.0f%%"),
+        read_display, read_unit, disk->read_iops,
+        write_display, write_unit, disk->write_iops,
+        disk->busy_percent
+    );
+    
+    // Desglose por dispositivo (solo los que cuentan en el total), ordenado por nombre
+    GHashTable *disks = system_monitor_get_disks(self->monitor);
+    GList *names = g_list_sort(g_hash_table_get_keys(disks), (GCompareFunc)g_strcmp0);
+    guint included = 0;
+    for (GList *l = names; l; l = l->next) {
+        const SystemMonitorDevice *device = g_hash_table_lookup(disks, l->data);
+        if (device->included) included++;
+    }
+    
+    if (included > 1) {
+        for (GList *l = names; l; l = l->next) {
+            const SystemMonitorDevice *device = g_hash_table_lookup(disks, l->data);
+            if (!device->included) continue;
+            
+            read_display = device->read_speed;
+            write_display = device->write_speed;
+            read_unit = system_monitor_scale_speed(&read_display);
+            write_unit = system_monitor_scale_speed(&write_display);
+            g_string_append_printf(tooltip, "\n%s: R %.1f %s  W %.1f %s  %.0f%%",
+                                   device->name, read_display, read_unit,
+                                   write_display, write_unit, device->busy_percent);
+        }
+    }
+    g_list_free(names);
+    
+    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip->str);
+    g_string_free(tooltip, TRUE);
+}
+
+static void draw_disk_graph(GtkDrawingArea *area, cairo_t *cr,
+                            int width, int height, gpointer user_data) {
+    DiskMonitorWidget *self = DISK_MONITOR_WIDGET(user_data);
+    
+    if (self->activity) {
+        monitor_activity_drawn(self->activity);
+    }
+    
+    if (self->graph) {
+        monitor_graph_draw(self->graph, cr, width, height,
+                           gtk_widget_get_scale_factor(GTK_WIDGET(area)));
+    }
+}
+
+static void on_monitor_updated(SystemMonitor *monitor, guint sources, gpointer user_data) {
+    DiskMonitorWidget *self = DISK_MONITOR_WIDGET(user_data);
+    
+    if (!(sources & SYSTEM_MONITOR_DISK)) return;
+    
+    const SystemMonitorDisk *disk = &system_monitor_get_snapshot(monitor)->disk;
+    
+    // Actualizar escala máxima
+    double max_current = MAX(disk->read_speed, disk->write_speed);
+    if (max_current > self->max_speed) {
+        self->max_speed = max_current;
+        monitor_graph_set_max(self->graph, self->max_speed);
+    }
+    
+    // Actualizar historial
+    double speeds[] = { disk->read_speed, disk->write_speed };
+    monitor_graph_push_repeat(self->graph, speeds,
+                              system_monitor_get_periods(monitor, SYSTEM_MONITOR_DISK));
+    
+    // Marcar la saturación: es lo que de verdad explica un sistema lento
+    if (disk->busy_percent >= DISK_SATURATED_PERCENT) {
+        gtk_widget_add_css_class(self->drawing_area, "disk-saturated");
+    } else {
+        gtk_widget_remove_css_class(self->drawing_area, "disk-saturated");
+    }
+    
+    update_tooltip(self, disk);
+    
+    // Redibujar
+    monitor_activity_queue_draw(self->activity, self->drawing_area);
+}
+
+static void disk_monitor_widget_dispose(GObject *object) {
+    DiskMonitorWidget *self = DISK_MONITOR_WIDGET(object);
+    
+    if (self->activity) {
+        monitor_activity_free(self->activity);
+        self->activity = NULL;
+    }
+    
+    if (self->monitor) {
+        g_signal_handler_disconnect(self->monitor, self->updated_handler);
+        system_monitor_unsubscribe(self->monitor, SYSTEM_MONITOR_DISK);
+        self->monitor = NULL;
+    }
+    
+    if (self->graph) {
+        monitor_graph_free(self->graph);
+        self->graph = NULL;
+    }
+    
+    G_OBJECT_CLASS(disk_monitor_widget_parent_class)->dispose(object);
+}
+
+static void disk_monitor_widget_init(DiskMonitorWidget *self) {
+    self->max_speed = 1024.0; // Escala inicial: 1 MB/s
+    
+    // Crear drawing area para la gráfica
+    self->drawing_area = gtk_drawing_area_new();
+    gtk_widget_add_css_class(self->drawing_area, "disk-monitor-graph");
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(self->drawing_area),
+                                   draw_disk_graph, self, NULL);
+    gtk_box_append(GTK_BOX(self), self->drawing_area);
+    
+    // Cargar CSS desde GResource
+    static gboolean styles_applied = FALSE;
+    if (!styles_applied) {
+        GtkCssProvider *css_provider = gtk_css_provider_new();
+        gtk_css_provider_load_from_resource(css_provider, "/io/gitlab/sodomon/simple_panel/styles/monitor-styles.css");
+        gtk_style_context_add_provider_for_display(
+            gdk_display_get_default(),
+            GTK_STYLE_PROVIDER(css_provider),
+            GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
+        );
+        g_object_unref(css_provider);
+        styles_applied = TRUE;
+    }
+}
+
+// Crear el historial y suscribirse al muestreador DESPUÉS de establecer config
+static void disk_monitor_widget_start(DiskMonitorWidget *self) {
+    // Como la red, el throughput abarca varios órdenes de magnitud
+    self->graph = monitor_graph_new(2, self->config->disk_monitor_history, MONITOR_RING_LOG, 0.0);
+    monitor_graph_set_color(self->graph, 0, 0.2, 0.6, 1.0); // Lectura - Azul
+    monitor_graph_set_color(self->graph, 1, 1.0, 0.6, 0.0); // Escritura - Naranja
+    monitor_graph_set_max(self->graph, self->max_speed);
+    monitor_graph_set_scrolling(self->graph, self->config->disk_monitor_scrolling);
+    
+    self->monitor = system_monitor_get_default();
+    system_monitor_set_disk_filter(self->monitor, self->config->disk_monitor_include,
+                                   self->config->disk_monitor_exclude,
+                                   self->config->disk_monitor_partitions);
+    self->updated_handler = g_signal_connect(self->monitor, "updated",
+                                             G_CALLBACK(on_monitor_updated), self);
+    system_monitor_subscribe(self->monitor, SYSTEM_MONITOR_DISK, self->config->disk_monitor_interval_ms);
+    self->activity = monitor_activity_new(GTK_WIDGET(self), self->monitor, SYSTEM_MONITOR_DISK);
+}
+
+static void disk_monitor_widget_class_init(DiskMonitorWidgetClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = disk_monitor_widget_dispose;
+}
+
+GtkWidget *disk_monitor_widget_new(PanelConfig *config) {
+    DiskMonitorWidget *self = g_object_new(DISK_TYPE_MONITOR_WIDGET, NULL);
+    self->config = config;
+    disk_monitor_widget_start(self);
+    return GTK_WIDGET(self);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "../config.h"
+
+G_BEGIN_DECLS
+
+#define DISK_TYPE_MONITOR_WIDGET (disk_monitor_widget_get_type())
+G_DECLARE_FINAL_TYPE(DiskMonitorWidget, disk_monitor_widget, DISK, MONITOR_WIDGET, GtkBox)
+
+GtkWidget *disk_monitor_widget_new(PanelConfig *config);
+
+G_END_DECLS
@@ -1,4 +1,5 @@
 #include "launcher_widget.h"
+#include "../app_icon_cache.h"
 #include <stdlib.h>
 
 typedef struct {
@@ -9,12 +10,17 @@ typedef struct {
     gchar *command;
     gchar *type;
     gint order;
+    GtkWidget *image;
 } LauncherItem;
 
 struct _LauncherWidget {
     GtkBox parent_instance;
     PanelConfig *config;
     GSList *launcher_items;
+    
+    // `icon` puede ser un nombre de icono o el id de una aplicación
+    AppIconCache *icon_cache;
+    gulong icon_cache_handler;
 };
 
 G_DEFINE_TYPE(LauncherWidget, launcher_widget, GTK_TYPE_BOX)
@@ -130,6 +136,18 @@ static void load_launcher_items(LauncherWidget *self) {
         (GCompareFunc)launcher_item_compare);
 }
 
+// Ha cambiado algún .desktop: volver a resolver los iconos
+static void on_icon_cache_changed(AppIconCache *cache, gpointer user_data) {
+    LauncherWidget *self = LAUNCHER_WIDGET(user_data);
+    
+    for (GSList *l = self->launcher_items; l != NULL; l = l->next) {
+        LauncherItem *item = (LauncherItem *)l->data;
+        if (item->image) {
+            gtk_image_set_from_gicon(GTK_IMAGE(item->image), app_icon_cache_lookup_icon(cache, item->icon));
+        }
+    }
+}
+
 // Crear widgets para los launchers
 static void create_launcher_widgets(LauncherWidget *self) {
     // Cargar CSS desde GResource
@@ -161,7 +179,10 @@ static void create_launcher_widgets(LauncherWidget *self) {
             
             // Configurar icono
             if (item->icon) {
-                gtk_button_set_icon_name(GTK_BUTTON(button), item->icon);
+                item->image = gtk_image_new_from_gicon(app_icon_cache_lookup_icon(self->icon_cache,
+                                                                                  item->icon));
+                gtk_button_set_child(GTK_BUTTON(button), item->image);
+                gtk_widget_add_css_class(button, "image-button");
             }
             
             // Configurar tooltip
@@ -179,6 +200,9 @@ static void create_launcher_widgets(LauncherWidget *self) {
 
 static void launcher_widget_init(LauncherWidget *self) {
     self->launcher_items = NULL;
+    self->icon_cache = app_icon_cache_get_default();
+    self->icon_cache_handler = g_signal_connect(self->icon_cache, "changed",
+                                                G_CALLBACK(on_icon_cache_changed), self);
     
     // Cargar configuración y crear widgets
     load_launcher_items(self);
@@ -188,6 +212,11 @@ static void launcher_widget_init(LauncherWidget *self) {
 static void launcher_widget_dispose(GObject *object) {
     LauncherWidget *self = LAUNCHER_WIDGET(object);
     
+    if (self->icon_cache) {
+        g_signal_handler_disconnect(self->icon_cache, self->icon_cache_handler);
+        self->icon_cache = NULL;
+    }
+    
     // Limpiar lista de launcher items
     for (GSList *l = self->launcher_items; l != NULL; l = l->next) {
         launcher_item_free((LauncherItem *)l->data);
@@ -1,24 +1,22 @@
 #include "net_monitor_widget.h"
 #include "../i18n.h"
-#include <stdio.h>
-#include <string.h>
-
-#define HISTORY_SIZE 30
+#include "../system_monitor.h"
+#include "../monitor_graph.h"
+#include "../monitor_activity.h"
 
 struct _NetMonitorWidget {
     GtkBox parent_instance;
     
     GtkWidget *drawing_area;
-    guint timeout_id;
+    PanelConfig *config;
     
-    // Historial de tráfico de red
-    double rx_history[HISTORY_SIZE];
-    double tx_history[HISTORY_SIZE];
-    int history_index;
+    // Muestreador compartido
+    SystemMonitor *monitor;
+    gulong updated_handler;
+    MonitorActivity *activity;
     
-    // Datos anteriores para calcular velocidad
-    gulong prev_rx_bytes;
-    gulong prev_tx_bytes;
+    // Historial de tráfico de red (serie 0: RX, serie 1: TX)
+    MonitorGraph *graph;
     
     // Velocidades actuales (KB/s)
     double current_rx_speed;
@@ -28,69 +26,14 @@ struct _NetMonitorWidget {
 
 G_DEFINE_TYPE(NetMonitorWidget, net_monitor_widget, GTK_TYPE_BOX)
 
-static void read_network_info(NetMonitorWidget *self) {
-    FILE *file = fopen("/proc/net/dev", "r");
-    if (!file) return;
-    
-    char line[256];
-    gulong total_rx = 0, total_tx = 0;
-    
-    // Saltar las dos primeras líneas (headers)
-    fgets(line, sizeof(line), file);
-    fgets(line, sizeof(line), file);
-    
-    while (fgets(line, sizeof(line), file)) {
-        char interface[16];
-        gulong rx_bytes, tx_bytes;
-        gulong dummy;
-        
-        // Parsear línea: interface: rx_bytes rx_packets ... tx_bytes tx_packets ...
-        if (sscanf(line, "%15[^:]: %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu", 
-                   interface, &rx_bytes, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
-                   &tx_bytes, &dummy) >= 10) {
-            
-            // Saltar loopback
-            if (strcmp(interface, "lo") == 0) continue;
-            
-            total_rx += rx_bytes;
-            total_tx += tx_bytes;
-        }
-    }
-    fclose(file);
-    
-    // Calcular velocidad (KB/s)
-    if (self->prev_rx_bytes > 0) {
-        self->current_rx_speed = (total_rx - self->prev_rx_bytes) / 1024.0; // KB/s
-        self->current_tx_speed = (total_tx - self->prev_tx_bytes) / 1024.0;
-        
-        // Actualizar escala máxima
-        double max_current = (self->current_rx_speed > self->current_tx_speed) ? 
-                            self->current_rx_speed : self->current_tx_speed;
-        if (max_current > self->max_speed) {
-            self->max_speed = max_current;
-        }
-    }
-    
-    self->prev_rx_bytes = total_rx;
-    self->prev_tx_bytes = total_tx;
-}
-
 static void update_tooltip(NetMonitorWidget *self) {
-    const gchar *rx_unit = "KB/s";
-    const gchar *tx_unit = "KB/s";
     double rx_display = self->current_rx_speed;
     double tx_display = self->current_tx_speed;
+    const gchar *rx_unit = system_monitor_scale_speed(&rx_display);
+    const gchar *tx_unit = system_monitor_scale_speed(&tx_display);
     
-    if (rx_display > 1024) {
-        rx_display /= 1024.0;
-        rx_unit = "MB/s";
-    }
-    if (tx_display > 1024) {
-        tx_display /= 1024.0;
-        tx_unit = "MB/s";
-    }
-    
-    gchar *tooltip = g_strdup_printf(
+    GString *tooltip = g_string_new(NULL);
+    g_string_printf(tooltip,
         _("Network:\n"
         "↓ %.1f %s\n"
         "↑ %.1f %s"),
@@ -98,95 +41,98 @@ static void update_tooltip(NetMonitorWidget *self) {
         tx_display, tx_unit
     );
     
-    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip);
-    g_free(tooltip);
+    // Desglose por interfaz (solo las que cuentan en el total), ordenado por nombre
+    GHashTable *interfaces = system_monitor_get_interfaces(self->monitor);
+    GList *names = g_list_sort(g_hash_table_get_keys(interfaces), (GCompareFunc)g_strcmp0);
+    guint included = 0;
+    for (GList *l = names; l; l = l->next) {
+        const SystemMonitorInterface *iface = g_hash_table_lookup(interfaces, l->data);
+        if (iface->included) included++;
+    }
+    
+    if (included > 1) {
+        for (GList *l = names; l; l = l->next) {
+            const SystemMonitorInterface *iface = g_hash_table_lookup(interfaces, l->data);
+            if (!iface->included) continue;
+            
+            rx_display = iface->rx_speed;
+            tx_display = iface->tx_speed;
+            rx_unit = system_monitor_scale_speed(&rx_display);
+            tx_unit = system_monitor_scale_speed(&tx_display);
+            g_string_append_printf(tooltip, "\n%s: ↓ %.1f %s  ↑ %.1f %s",
+                                   iface->name, rx_display, rx_unit, tx_display, tx_unit);
+        }
+    }
+    g_list_free(names);
+    
+    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip->str);
+    g_string_free(tooltip, TRUE);
 }
 
-static void draw_network_graph(GtkDrawingArea *area G_GNUC_UNUSED, cairo_t *cr,
+static void draw_network_graph(GtkDrawingArea *area, cairo_t *cr,
                               int width, int height, gpointer user_data) {
     NetMonitorWidget *self = NET_MONITOR_WIDGET(user_data);
     
-    // Fondo
-    cairo_set_source_rgba(cr, 0.0, 0.0, 0.0, 0.3);
-    cairo_rectangle(cr, 0, 0, width, height);
-    cairo_fill(cr);
-    
-    if (self->max_speed <= 0) return;
-    
-    double x_step = (double)width / (HISTORY_SIZE - 1);
-    double scale = (double)height / self->max_speed;
-    
-    cairo_set_line_width(cr, 1.0);
-    
-    // Línea RX (descarga) - Verde
-    cairo_set_source_rgba(cr, 0.0, 0.8, 0.0, 1.0);
-    for (int i = 0; i < HISTORY_SIZE - 1; i++) {
-        int idx1 = (self->history_index + i) % HISTORY_SIZE;
-        int idx2 = (self->history_index + i + 1) % HISTORY_SIZE;
-        
-        double x1 = i * x_step;
-        double x2 = (i + 1) * x_step;
-        double y1 = height - (self->rx_history[idx1] * scale);
-        double y2 = height - (self->rx_history[idx2] * scale);
-        
-        cairo_move_to(cr, x1, y1);
-        cairo_line_to(cr, x2, y2);
-        cairo_stroke(cr);
+    if (self->activity) {
+        monitor_activity_drawn(self->activity);
     }
     
-    // Línea TX (subida) - Rojo
-    cairo_set_source_rgba(cr, 0.8, 0.0, 0.0, 1.0);
-    for (int i = 0; i < HISTORY_SIZE - 1; i++) {
-        int idx1 = (self->history_index + i) % HISTORY_SIZE;
-        int idx2 = (self->history_index + i + 1) % HISTORY_SIZE;
-        
-        double x1 = i * x_step;
-        double x2 = (i + 1) * x_step;
-        double y1 = height - (self->tx_history[idx1] * scale);
-        double y2 = height - (self->tx_history[idx2] * scale);
-        
-        cairo_move_to(cr, x1, y1);
-        cairo_line_to(cr, x2, y2);
-        cairo_stroke(cr);
+    if (self->graph) {
+        monitor_graph_draw(self->graph, cr, width, height,
+                           gtk_widget_get_scale_factor(GTK_WIDGET(area)));
     }
 }
 
-static gboolean on_update_network(gpointer user_data) {
+static void on_monitor_updated(SystemMonitor *monitor, guint sources, gpointer user_data) {
     NetMonitorWidget *self = NET_MONITOR_WIDGET(user_data);
     
-    read_network_info(self);
+    if (!(sources & SYSTEM_MONITOR_NETWORK)) return;
+    
+    const SystemMonitorNetwork *net = &system_monitor_get_snapshot(monitor)->network;
+    self->current_rx_speed = net->rx_speed;
+    self->current_tx_speed = net->tx_speed;
+    
+    // Actualizar escala máxima
+    double max_current = MAX(self->current_rx_speed, self->current_tx_speed);
+    if (max_current > self->max_speed) {
+        self->max_speed = max_current;
+        monitor_graph_set_max(self->graph, self->max_speed);
+    }
     
     // Actualizar historial
-    self->rx_history[self->history_index] = self->current_rx_speed;
-    self->tx_history[self->history_index] = self->current_tx_speed;
-    self->history_index = (self->history_index + 1) % HISTORY_SIZE;
+    double speeds[] = { self->current_rx_speed, self->current_tx_speed };
+    monitor_graph_push_repeat(self->graph, speeds,
+                              system_monitor_get_periods(monitor, SYSTEM_MONITOR_NETWORK));
     
     update_tooltip(self);
     
     // Redibujar
-    gtk_widget_queue_draw(self->drawing_area);
-    
-    return G_SOURCE_CONTINUE;
+    monitor_activity_queue_draw(self->activity, self->drawing_area);
 }
 
 static void net_monitor_widget_dispose(GObject *object) {
     NetMonitorWidget *self = NET_MONITOR_WIDGET(object);
     
-    if (self->timeout_id > 0) {
-        g_source_remove(self->timeout_id);
-        self->timeout_id = 0;
+    if (self->activity) {
+        monitor_activity_free(self->activity);
+        self->activity = NULL;
+    }
+    
+    if (self->monitor) {
+        g_signal_handler_disconnect(self->monitor, self->updated_handler);
+        system_monitor_unsubscribe(self->monitor, SYSTEM_MONITOR_NETWORK);
+        self->monitor = NULL;
+    }
+    
+    if (self->graph) {
+        monitor_graph_free(self->graph);
+        self->graph = NULL;
     }
     
     G_OBJECT_CLASS(net_monitor_widget_parent_class)->dispose(object);
 }
 
 static void net_monitor_widget_init(NetMonitorWidget *self) {
-    // Inicializar historial
-    for (int i = 0; i < HISTORY_SIZE; i++) {
-        self->rx_history[i] = 0.0;
-        self->tx_history[i] = 0.0;
-    }
-    self->history_index = 0;
     self->max_speed = 100.0; // Escala inicial: 100 KB/s
     
     // Crear drawing area para la gráfica
@@ -209,12 +155,27 @@ static void net_monitor_widget_init(NetMonitorWidget *self) {
         g_object_unref(css_provider);
         styles_applied = TRUE;
     }
-    
-    // Primera lectura para inicializar
-    read_network_info(self);
-    
-    // Timer cada segundo
-    self->timeout_id = g_timeout_add_seconds(1, on_update_network, self);
+}
+
+// Crear el historial y suscribirse al muestreador DESPUÉS de establecer config
+static void net_monitor_widget_start(NetMonitorWidget *self) {
+    // Las velocidades abarcan varios órdenes de magnitud: escala logarítmica
+    self->graph = monitor_graph_new(2, self->config->net_monitor_history, MONITOR_RING_LOG, 0.0);
+    monitor_graph_set_color(self->graph, 0, 0.0, 0.8, 0.0); // RX (descarga) - Verde
+    monitor_graph_set_color(self->graph, 1, 0.8, 0.0, 0.0); // TX (subida) - Rojo
+    monitor_graph_set_max(self->graph, self->max_speed);
+    monitor_graph_set_scrolling(self->graph, self->config->net_monitor_scrolling);
+    
+    self->monitor = system_monitor_get_default();
+    system_monitor_set_network_filter(self->monitor, self->config->net_monitor_include,
+                                      self->config->net_monitor_exclude);
+    system_monitor_set_network_backend(self->monitor,
+                                       g_strcmp0(self->config->net_monitor_backend, "netlink") == 0 ?
+                                       SYSTEM_MONITOR_NET_NETLINK : SYSTEM_MONITOR_NET_PROC);
+    self->updated_handler = g_signal_connect(self->monitor, "updated",
+                                             G_CALLBACK(on_monitor_updated), self);
+    system_monitor_subscribe(self->monitor, SYSTEM_MONITOR_NETWORK, self->config->net_monitor_interval_ms);
+    self->activity = monitor_activity_new(GTK_WIDGET(self), self->monitor, SYSTEM_MONITOR_NETWORK);
 }
 
 static void net_monitor_widget_class_init(NetMonitorWidgetClass *klass) {
@@ -222,6 +183,9 @@ static void net_monitor_widget_class_init(NetMonitorWidgetClass *klass) {
     object_class->dispose = net_monitor_widget_dispose;
 }
 
-GtkWidget *net_monitor_widget_new(void) {
-    return g_object_new(NET_TYPE_MONITOR_WIDGET, NULL);
+GtkWidget *net_monitor_widget_new(PanelConfig *config) {
+    NetMonitorWidget *self = g_object_new(NET_TYPE_MONITOR_WIDGET, NULL);
+    self->config = config;
+    net_monitor_widget_start(self);
+    return GTK_WIDGET(self);
 }
@@ -1,84 +1,174 @@
 #include "ram_monitor_widget.h"
 #include "../i18n.h"
-#include <stdio.h>
+#include "../system_monitor.h"
+#include "../monitor_ring.h"
+#include "../monitor_activity.h"
+#include "../process_popover.h"
+
+// Umbrales de PSI (avg10, %) para marcar la barra como bajo presión
+#define PRESSURE_WARNING_SOME 10.0
+#define PRESSURE_CRITICAL_FULL 5.0
 
 struct _RamMonitorWidget {
     GtkBox parent_instance;
     
     GtkWidget *progress_bar;
-    guint timeout_id;
+    PanelConfig *config;
+    
+    // Muestreador compartido
+    SystemMonitor *monitor;
+    gulong updated_handler;
+    MonitorActivity *activity;
+    
+    // Procesos que más memoria usan, al hacer clic
+    GtkWidget *process_popover;
     
     // Datos de memoria
     double mem_total_gb;
     double mem_used_gb;
     double mem_free_gb;
     double mem_percent;
+    
+    // Historial de porcentajes de uso, para el pico del tooltip
+    MonitorRing *history;
 };
 
 G_DEFINE_TYPE(RamMonitorWidget, ram_monitor_widget, GTK_TYPE_BOX)
 
 static void read_memory_info(RamMonitorWidget *self) {
-    FILE *file = fopen("/proc/meminfo", "r");
-    if (!file) return;
-    
-    gulong mem_total = 0, mem_free = 0, mem_available = 0, buffers = 0, cached = 0;
-    char line[256];
-    
-    while (fgets(line, sizeof(line), file)) {
-        if (sscanf(line, "MemTotal: %lu kB", &mem_total) == 1) continue;
-        if (sscanf(line, "MemFree: %lu kB", &mem_free) == 1) continue;
-        if (sscanf(line, "MemAvailable: %lu kB", &mem_available) == 1) continue;
-        if (sscanf(line, "Buffers: %lu kB", &buffers) == 1) continue;
-        if (sscanf(line, "Cached: %lu kB", &cached) == 1) continue;
-    }
-    fclose(file);
-    
-    if (mem_total > 0) {
-        // Usar MemAvailable si está disponible, sino calcular
-        gulong mem_used = mem_available > 0 ? 
-            mem_total - mem_available : 
-            mem_total - mem_free - buffers - cached;
-            
-        self->mem_total_gb = mem_total / (1024.0 * 1024.0);
-        self->mem_used_gb = mem_used / (1024.0 * 1024.0);
+    const SystemMonitorMemory *mem = &system_monitor_get_snapshot(self->monitor)->memory;
+    
+    if (mem->total_kb > 0) {
+        self->mem_total_gb = mem->total_kb / (1024.0 * 1024.0);
+        self->mem_used_gb = mem->used_kb / (1024.0 * 1024.0);
         self->mem_free_gb = self->mem_total_gb - self->mem_used_gb;
-        self->mem_percent = (mem_used * 100.0) / mem_total;
+        self->mem_percent = mem->used_percent;
     }
 }
 
 static void update_tooltip(RamMonitorWidget *self) {
-    gchar *tooltip = g_strdup_printf(
+    double peak = self->mem_percent;
+    for (guint age = 0; age < self->history->length; age++) {
+        peak = MAX(peak, monitor_ring_get(self->history, age));
+    }
+    
+    GString *tooltip = g_string_new(NULL);
+    g_string_printf(tooltip,
         _("RAM: %.1f GB / %.1f GB (%.1f%%)\n"
         "Used: %.1f GB\n"
-        "Free: %.1f GB"),
+        "Free: %.1f GB\n"
+        "Peak: %.1f%%"),
         self->mem_used_gb, self->mem_total_gb, self->mem_percent,
-        self->mem_used_gb, self->mem_free_gb
+        self->mem_used_gb, self->mem_free_gb, peak
     );
     
-    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip);
-    g_free(tooltip);
+    const SystemMonitorSnapshot *snapshot = system_monitor_get_snapshot(self->monitor);
+    const SystemMonitorMemory *mem = &snapshot->memory;
+    
+    if (mem->swap_total_kb > 0) {
+        g_string_append_c(tooltip, '\n');
+        g_string_append_printf(tooltip, _("Swap: %.1f GB / %.1f GB"),
+                               mem->swap_used_kb / (1024.0 * 1024.0),
+                               mem->swap_total_kb / (1024.0 * 1024.0));
+    }
+    if (mem->zswapped_kb > 0) {
+        g_string_append_c(tooltip, '\n');
+        g_string_append_printf(tooltip, _("Zswap: %.1f MB compressed to %.1f MB"),
+                               mem->zswapped_kb / 1024.0, mem->zswap_kb / 1024.0);
+    }
+    if (snapshot->pressure.available) {
+        g_string_append_c(tooltip, '\n');
+        g_string_append_printf(tooltip, _("Pressure: memory %.1f%% (full %.1f%%), CPU %.1f%%"),
+                               snapshot->pressure.memory.some_avg10,
+                               snapshot->pressure.memory.full_avg10,
+                               snapshot->pressure.cpu.some_avg10);
+    }
+    
+    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip->str);
+    g_string_free(tooltip, TRUE);
+}
+
+// Colorear la barra según la presión de memoria (PSI)
+static void update_pressure_overlay(RamMonitorWidget *self) {
+    const SystemMonitorPressure *pressure = &system_monitor_get_snapshot(self->monitor)->pressure;
+    gboolean critical = pressure->available && pressure->memory.full_avg10 >= PRESSURE_CRITICAL_FULL;
+    gboolean warning = !critical && pressure->available &&
+                       pressure->memory.some_avg10 >= PRESSURE_WARNING_SOME;
+    
+    if (critical) {
+        gtk_widget_add_css_class(self->progress_bar, "pressure-critical");
+    } else {
+        gtk_widget_remove_css_class(self->progress_bar, "pressure-critical");
+    }
+    
+    if (warning) {
+        gtk_widget_add_css_class(self->progress_bar, "pressure-warning");
+    } else {
+        gtk_widget_remove_css_class(self->progress_bar, "pressure-warning");
+    }
 }
 
-static gboolean on_update_memory(gpointer user_data) {
+static void on_monitor_updated(SystemMonitor *monitor, guint sources, gpointer user_data) {
     RamMonitorWidget *self = RAM_MONITOR_WIDGET(user_data);
     
-    read_memory_info(self);
+    if (!(sources & (SYSTEM_MONITOR_MEMORY | SYSTEM_MONITOR_PRESSURE))) return;
+    
+    if (sources & SYSTEM_MONITOR_MEMORY) {
+        read_memory_info(self);
+        
+        guint periods = MIN(system_monitor_get_periods(monitor, SYSTEM_MONITOR_MEMORY),
+                            self->history->capacity);
+        for (guint i = 0; i < periods; i++) {
+            monitor_ring_push(self->history, self->mem_percent);
+        }
+        
+        // Actualizar progress bar
+        gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(self->progress_bar), 
+                                     self->mem_percent / 100.0);
+    }
     
-    // Actualizar progress bar
-    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(self->progress_bar), 
-                                 self->mem_percent / 100.0);
+    if (sources & SYSTEM_MONITOR_PRESSURE) {
+        update_pressure_overlay(self);
+    }
     
     update_tooltip(self);
+}
+
+static void on_widget_pressed(GtkGestureClick *gesture G_GNUC_UNUSED, gint n_press G_GNUC_UNUSED,
+                              gdouble x G_GNUC_UNUSED, gdouble y G_GNUC_UNUSED, gpointer user_data) {
+    RamMonitorWidget *self = RAM_MONITOR_WIDGET(user_data);
     
-    return G_SOURCE_CONTINUE;
+    if (gtk_widget_get_visible(self->process_popover)) {
+        gtk_popover_popdown(GTK_POPOVER(self->process_popover));
+    } else {
+        monitor_activity_boost(self->activity);
+        gtk_popover_popup(GTK_POPOVER(self->process_popover));
+    }
 }
 
 static void ram_monitor_widget_dispose(GObject *object) {
     RamMonitorWidget *self = RAM_MONITOR_WIDGET(object);
     
-    if (self->timeout_id > 0) {
-        g_source_remove(self->timeout_id);
-        self->timeout_id = 0;
+    if (self->process_popover) {
+        gtk_widget_unparent(self->process_popover);
+        self->process_popover = NULL;
+    }
+    
+    if (self->activity) {
+        monitor_activity_free(self->activity);
+        self->activity = NULL;
+    }
+    
+    if (self->monitor) {
+        g_signal_handler_disconnect(self->monitor, self->updated_handler);
+        system_monitor_unsubscribe(self->monitor, SYSTEM_MONITOR_MEMORY);
+        system_monitor_unsubscribe(self->monitor, SYSTEM_MONITOR_PRESSURE);
+        self->monitor = NULL;
+    }
+    
+    if (self->history) {
+        monitor_ring_free(self->history);
+        self->history = NULL;
     }
     
     G_OBJECT_CLASS(ram_monitor_widget_parent_class)->dispose(object);
@@ -95,6 +185,13 @@ static void ram_monitor_widget_init(RamMonitorWidget *self) {
     gtk_widget_add_css_class(self->progress_bar, "ram-monitor-bar");
     gtk_box_append(GTK_BOX(self), self->progress_bar);
     
+    self->process_popover = process_popover_new(PROCESS_SORT_MEMORY);
+    gtk_widget_set_parent(self->process_popover, GTK_WIDGET(self));
+    
+    GtkGesture *click = gtk_gesture_click_new();
+    g_signal_connect(click, "pressed", G_CALLBACK(on_widget_pressed), self);
+    gtk_widget_add_controller(GTK_WIDGET(self), GTK_EVENT_CONTROLLER(click));
+    
     // Cargar CSS desde GResource
     static gboolean styles_applied = FALSE;
     if (!styles_applied) {
@@ -108,13 +205,28 @@ static void ram_monitor_widget_init(RamMonitorWidget *self) {
         g_object_unref(css_provider);
         styles_applied = TRUE;
     }
+}
+
+// Suscribirse al muestreador DESPUÉS de establecer config
+static void ram_monitor_widget_start(RamMonitorWidget *self) {
+    self->history = monitor_ring_new(self->config->ram_monitor_history, MONITOR_RING_LINEAR, 100.0);
+    
+    self->monitor = system_monitor_get_default();
+    self->updated_handler = g_signal_connect(self->monitor, "updated",
+                                             G_CALLBACK(on_monitor_updated), self);
+    system_monitor_subscribe(self->monitor, SYSTEM_MONITOR_MEMORY, self->config->ram_monitor_interval_ms);
+    
+    // PSI: el trigger del kernel avisa de la presión sin necesidad de muestrear más rápido
+    system_monitor_subscribe(self->monitor, SYSTEM_MONITOR_PRESSURE, self->config->ram_monitor_interval_ms);
+    self->activity = monitor_activity_new(GTK_WIDGET(self), self->monitor,
+                                          SYSTEM_MONITOR_MEMORY | SYSTEM_MONITOR_PRESSURE);
     
     // Actualización inmediata
     read_memory_info(self);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(self->progress_bar), 
+                                 self->mem_percent / 100.0);
+    update_pressure_overlay(self);
     update_tooltip(self);
-    
-    // Timer cada 2 segundos
-    self->timeout_id = g_timeout_add_seconds(2, on_update_memory, self);
 }
 
 static void ram_monitor_widget_class_init(RamMonitorWidgetClass *klass) {
@@ -122,6 +234,9 @@ static void ram_monitor_widget_class_init(RamMonitorWidgetClass *klass) {
     object_class->dispose = ram_monitor_widget_dispose;
 }
 
-GtkWidget *ram_monitor_widget_new(void) {
-    return g_object_new(RAM_TYPE_MONITOR_WIDGET, NULL);
+GtkWidget *ram_monitor_widget_new(PanelConfig *config) {
+    RamMonitorWidget *self = g_object_new(RAM_TYPE_MONITOR_WIDGET, NULL);
+    self->config = config;
+    ram_monitor_widget_start(self);
+    return GTK_WIDGET(self);
 }
@@ -0,0 +1,147 @@
+#include "sensors_widget.h"
+#include "../i18n.h"
+#include "../system_monitor.h"
+#include "../monitor_activity.h"
+
+struct _SensorsWidget {
+    GtkBox parent_instance;
+    
+    GtkWidget *label;
+    PanelConfig *config;
+    
+    // Muestreador compartido
+    SystemMonitor *monitor;
+    gulong updated_handler;
+    MonitorActivity *activity;
+};
+
+G_DEFINE_TYPE(SensorsWidget, sensors_widget, GTK_TYPE_BOX)
+
+static void set_css_class(GtkWidget *widget, const gchar *css_class, gboolean enabled) {
+    if (enabled) {
+        gtk_widget_add_css_class(widget, css_class);
+    } else {
+        gtk_widget_remove_css_class(widget, css_class);
+    }
+}
+
+static void update_tooltip(SensorsWidget *self, const SystemMonitorSensors *sensors) {
+    GString *tooltip = g_string_new(NULL);
+    
+    for (guint i = 0; i < sensors->n_sensors; i++) {
+        const SystemMonitorSensor *sensor = &sensors->sensors[i];
+        if (!sensor->valid) continue;
+        
+        if (tooltip->len > 0) g_string_append_c(tooltip, '\n');
+        
+        if (sensor->kind == SYSTEM_MONITOR_SENSOR_TEMPERATURE) {
+            g_string_append_printf(tooltip, "%s: %.0f °C", sensor->label, sensor->value);
+        } else if (sensor->charging) {
+            g_string_append_printf(tooltip, _("%s: %.0f%% (charging)"), sensor->label, sensor->value);
+        } else {
+            g_string_append_printf(tooltip, "%s: %.0f%%", sensor->label, sensor->value);
+        }
+    }
+    
+    if (sensors->has_frequency) {
+        if (tooltip->len > 0) g_string_append_c(tooltip, '\n');
+        g_string_append_printf(tooltip, _("CPU frequency: %.0f MHz"), sensors->frequency);
+    }
+    
+    gtk_widget_set_tooltip_text(GTK_WIDGET(self), tooltip->len > 0 ? tooltip->str : NULL);
+    g_string_free(tooltip, TRUE);
+}
+
+static void on_monitor_updated(SystemMonitor *monitor, guint sources, gpointer user_data) {
+    SensorsWidget *self = SENSORS_WIDGET(user_data);
+    
+    if (!(sources & SYSTEM_MONITOR_SENSORS)) return;
+    
+    const SystemMonitorSensors *sensors = &system_monitor_get_snapshot(monitor)->sensors;
+    GString *text = g_string_new(NULL);
+    
+    // Solo lo que exista en esta máquina: un sobremesa no tiene batería
+    if (sensors->has_temperature) {
+        g_string_append_printf(text, "%.0f°C", sensors->temperature);
+    }
+    if (sensors->has_frequency) {
+        if (text->len > 0) g_string_append(text, "  ");
+        g_string_append_printf(text, "%.1f GHz", sensors->frequency / 1000.0);
+    }
+    if (sensors->has_battery) {
+        if (text->len > 0) g_string_append(text, "  ");
+        g_string_append_printf(text, "%.0f%%", sensors->battery);
+    }
+    
+    gtk_label_set_text(GTK_LABEL(self->label), text->str);
+    gtk_widget_set_visible(self->label, text->len > 0);
+    g_string_free(text, TRUE);
+    
+    set_css_class(self->label, "sensors-hot",
+                  sensors->has_temperature && sensors->temperature >= self->config->sensors_warning_temp);
+    set_css_class(self->label, "battery-charging", sensors->has_battery && sensors->charging);
+    set_css_class(self->label, "battery-low", sensors->has_battery && !sensors->charging &&
+                  sensors->battery <= self->config->sensors_battery_low);
+    
+    update_tooltip(self, sensors);
+}
+
+static void sensors_widget_dispose(GObject *object) {
+    SensorsWidget *self = SENSORS_WIDGET(object);
+    
+    if (self->activity) {
+        monitor_activity_free(self->activity);
+        self->activity = NULL;
+    }
+    
+    if (self->monitor) {
+        g_signal_handler_disconnect(self->monitor, self->updated_handler);
+        system_monitor_unsubscribe(self->monitor, SYSTEM_MONITOR_SENSORS);
+        self->monitor = NULL;
+    }
+    
+    G_OBJECT_CLASS(sensors_widget_parent_class)->dispose(object);
+}
+
+static void sensors_widget_init(SensorsWidget *self) {
+    // Sin sensores descubiertos no se muestra nada
+    self->label = gtk_label_new(NULL);
+    gtk_widget_add_css_class(self->label, "sensors-label");
+    gtk_widget_set_visible(self->label, FALSE);
+    gtk_box_append(GTK_BOX(self), self->label);
+    
+    // Cargar CSS desde GResource
+    static gboolean styles_applied = FALSE;
+    if (!styles_applied) {
+        GtkCssProvider *css_provider = gtk_css_provider_new();
+        gtk_css_provider_load_from_resource(css_provider, "/io/gitlab/sodomon/simple_panel/styles/monitor-styles.css");
+        gtk_style_context_add_provider_for_display(
+            gdk_display_get_default(),
+            GTK_STYLE_PROVIDER(css_provider),
+            GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
+        );
+        g_object_unref(css_provider);
+        styles_applied = TRUE;
+    }
+}
+
+// Suscribirse al muestreador DESPUÉS de establecer config
+static void sensors_widget_start(SensorsWidget *self) {
+    self->monitor = system_monitor_get_default();
+    self->updated_handler = g_signal_connect(self->monitor, "updated",
+                                             G_CALLBACK(on_monitor_updated), self);
+    system_monitor_subscribe(self->monitor, SYSTEM_MONITOR_SENSORS, self->config->sensors_interval_ms);
+    self->activity = monitor_activity_new(GTK_WIDGET(self), self->monitor, SYSTEM_MONITOR_SENSORS);
+}
+
+static void sensors_widget_class_init(SensorsWidgetClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = sensors_widget_dispose;
+}
+
+GtkWidget *sensors_widget_new(PanelConfig *config) {
+    SensorsWidget *self = g_object_new(SENSORS_TYPE_WIDGET, NULL);
+    self->config = config;
+    sensors_widget_start(self);
+    return GTK_WIDGET(self);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "../config.h"
+
+G_BEGIN_DECLS
+
+#define SENSORS_TYPE_WIDGET (sensors_widget_get_type())
+G_DECLARE_FINAL_TYPE(SensorsWidget, sensors_widget, SENSORS, WIDGET, GtkBox)
+
+GtkWidget *sensors_widget_new(PanelConfig *config);
+
+G_END_DECLS
@@ -1,4 +1,5 @@
 #include "systray_widget.h"
+#include "../app_icon_cache.h"
 #include <gdk/gdk.h>
 
 // StatusNotifierItem DBus interface definitions
@@ -136,8 +137,11 @@ static void update_tray_item_icon(TrayItem *item) {
             g_object_unref(icon);
         }
     } else {
-        // Fallback: usar icono genérico
-        gtk_image_set_from_icon_name(GTK_IMAGE(item->icon_widget), "application-x-executable");
+        // Fallback: el icono del .desktop de la aplicación (o uno genérico)
+        AppIconCache *cache = app_icon_cache_get_default();
+        const gchar *app_id = item->id ? item->id : item->icon_name;
+        gtk_image_set_from_gicon(GTK_IMAGE(item->icon_widget),
+                                 app_icon_cache_lookup_icon(cache, app_id));
     }
 }
 
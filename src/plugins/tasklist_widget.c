@@ -1,19 +1,52 @@
 #define _GNU_SOURCE
 #include "tasklist_widget.h"
+#include "../app_icon_cache.h"
 #include <wayland-client.h>
+#include <glib-unix.h>
+#include <errno.h>
 
 #ifdef HAVE_WLR_PROTOCOLS
 #include "wlr-foreign-toplevel-management-unstable-v1-client-protocol.h"
 #endif
 
+// Cambios recibidos del compositor y aún sin aplicar: el protocolo los
+// agrupa y manda `done` al final de cada lote
+typedef enum {
+    TASK_CHANGED_TITLE  = 1 << 0,
+    TASK_CHANGED_APP_ID = 1 << 1,
+    TASK_CHANGED_STATE  = 1 << 2,
+} TaskChanges;
+
+// Tiempo máximo (µs) entre un clic y el cambio de estado que se le atribuye
+#define CLICK_LATENCY_TIMEOUT (2 * G_USEC_PER_SEC)
+
 // Estructura para cada ventana en la tasklist
 typedef struct {
     gchar *app_id;
     gchar *title;
     GtkWidget *button;
+    GtkWidget *icon;
+    GtkWidget *label;
     gboolean is_active;
     gboolean is_minimized;
     
+    // Nodo en TasklistWidget::task_order, para sacarlo en O(1)
+    GList *link;
+    
+    // Estado pendiente hasta el siguiente `done`
+    TaskChanges changes;
+    gchar *pending_title;
+    gchar *pending_app_id;
+    gboolean pending_active;
+    gboolean pending_minimized;
+    
+    // El título se pinta en el siguiente frame, no al llegar
+    gboolean title_dirty;
+    gint64 title_shown_time;    // tiempo del frame en que se pintó (µs monotónicos)
+    
+    // Clic aún sin respuesta del compositor, para medir la latencia; 0 si no hay
+    gint64 click_time;
+    
 #ifdef HAVE_WLR_PROTOCOLS
     struct zwlr_foreign_toplevel_handle_v1 *toplevel_handle;
 #endif
@@ -34,11 +67,31 @@ struct _TasklistWidget {
     struct wl_registry *wl_registry;
     struct wl_seat *wl_seat;
     struct zwlr_foreign_toplevel_manager_v1 *toplevel_manager;
+    
+    // Reintento de wl_display_flush mientras el socket esté lleno
+    guint flush_watch_id;
 #endif
     
-    // Task management
-    GSList *task_items;
+    // Task management: búsqueda por handle en O(1) (los navegadores y
+    // terminales mandan cambios de título continuamente) y orden de aparición
+    GHashTable *tasks;      // zwlr_foreign_toplevel_handle_v1 * → TaskItem *
+    GQueue task_order;
     TaskItem *active_task;
+    
+    // Títulos pendientes de pintar: como mucho una vez por frame, y las
+    // ventanas en segundo plano además limitadas a background_title_rate
+    GPtrArray *dirty_titles;
+    guint title_tick_id;
+    guint title_timeout_id;
+    
+    // Iconos resueltos por la caché compartida de app-id
+    AppIconCache *icon_cache;
+    gulong icon_cache_handler;
+    
+    // Latencia clic → cambio de estado (µs), acumulada para el log de depuración
+    guint click_count;
+    gint64 click_latency_total;
+    gint64 click_latency_max;
 };
 
 G_DEFINE_TYPE(TasklistWidget, tasklist_widget, GTK_TYPE_BOX)
@@ -48,10 +101,11 @@ G_DEFINE_TYPE(TasklistWidget, tasklist_widget, GTK_TYPE_BOX)
 static void setup_wayland_connection(TasklistWidget *self);
 static void setup_wayland_event_integration(TasklistWidget *self);
 static gboolean wayland_event_callback(GIOChannel *channel, GIOCondition condition, gpointer user_data);
-static TaskItem *create_task_item(TasklistWidget *tasklist, const char *app_id, const char *title);
+static TaskItem *create_task_item(TasklistWidget *tasklist,
+                                  struct zwlr_foreign_toplevel_handle_v1 *toplevel,
+                                  const char *app_id, const char *title);
 static void remove_task_item(TasklistWidget *tasklist, TaskItem *item);
 static void update_task_button_state(TaskItem *item);
-static gchar *get_icon_name_for_app_id(const gchar *app_id);
 static void update_task_button_icon(TaskItem *item);
 
 // Liberar memoria de un task item
@@ -60,6 +114,8 @@ static void task_item_free(TaskItem *item) {
     
     g_free(item->app_id);
     g_free(item->title);
+    g_free(item->pending_title);
+    g_free(item->pending_app_id);
     
     if (item->button) {
         gtk_widget_unparent(item->button);
@@ -72,6 +128,39 @@ static void task_item_free(TaskItem *item) {
     g_free(item);
 }
 
+// El socket vuelve a admitir datos: enviar lo que quedó en el buffer de
+// libwayland. Ningún watch usa wl_display_dispatch, que hace un flush
+// bloqueante antes de leer; el de lectura despacha con dispatch_pending
+static gboolean on_wayland_writable(gint fd G_GNUC_UNUSED, GIOCondition condition G_GNUC_UNUSED,
+                                    gpointer user_data) {
+    TasklistWidget *tasklist = TASKLIST_WIDGET(user_data);
+    
+    if (wl_display_flush(tasklist->wl_display) < 0) {
+        if (errno == EAGAIN) return G_SOURCE_CONTINUE;
+        g_warning("Error enviando petición al compositor: %s", g_strerror(errno));
+    }
+    
+    tasklist->flush_watch_id = 0;
+    return G_SOURCE_REMOVE;
+}
+
+// Enviar las peticiones sin bloquear; FALSE si la conexión falló
+static gboolean flush_wayland_requests(TasklistWidget *tasklist) {
+    if (wl_display_flush(tasklist->wl_display) >= 0) return TRUE;
+    
+    if (errno != EAGAIN) {
+        g_warning("Error enviando petición al compositor: %s", g_strerror(errno));
+        return FALSE;
+    }
+    
+    // Socket lleno: lo pendiente sale cuando vuelva a admitir escritura
+    if (tasklist->flush_watch_id == 0) {
+        tasklist->flush_watch_id = g_unix_fd_add(wl_display_get_fd(tasklist->wl_display),
+                                                 G_IO_OUT, on_wayland_writable, tasklist);
+    }
+    return TRUE;
+}
+
 // Callback cuando se hace clic en un botón de tarea
 static void on_task_button_clicked(GtkButton *button G_GNUC_UNUSED, gpointer user_data) {
     TaskItem *item = (TaskItem *)user_data;
@@ -97,11 +186,29 @@ static void on_task_button_clicked(GtkButton *button G_GNUC_UNUSED, gpointer use
         zwlr_foreign_toplevel_handle_v1_activate(item->toplevel_handle, item->tasklist->wl_seat);
     }
     
-    // ¡CRÍTICO! Forzar envío inmediato de comandos al compositor
-    wl_display_flush(item->tasklist->wl_display);
+    // Enviar la petición sin esperar respuesta: el nuevo estado llega por el
+    // watch del socket como cualquier otro evento. Un roundtrip aquí
+    // bloquearía el panel mientras el compositor esté ocupado
+    if (!flush_wayland_requests(item->tasklist)) {
+        return;
+    }
     
-    // Procesar respuesta del compositor
-    wl_display_roundtrip(item->tasklist->wl_display);
+    item->click_time = g_get_monotonic_time();
+}
+
+// Registrar cuánto ha tardado el compositor en aplicar el clic
+static void record_click_latency(TaskItem *item, gint64 click_time) {
+    TasklistWidget *tasklist = item->tasklist;
+    gint64 latency = g_get_monotonic_time() - click_time;
+    
+    tasklist->click_count++;
+    tasklist->click_latency_total += latency;
+    tasklist->click_latency_max = MAX(tasklist->click_latency_max, latency);
+    
+    g_debug("Clic → estado de '%s' en %.1f ms (media %.1f ms, máx %.1f ms en %u clics)",
+            item->title ? item->title : "", latency / 1000.0,
+            tasklist->click_latency_total / 1000.0 / tasklist->click_count,
+            tasklist->click_latency_max / 1000.0, tasklist->click_count);
 }
 
 // Crear botón GTK para una tarea
@@ -114,11 +221,11 @@ static GtkWidget *create_task_button(TaskItem *item) {
     gtk_button_set_child(GTK_BUTTON(button), box);
     
     // Icono - intentar obtener el correcto desde el principio
-    gchar *icon_name = get_icon_name_for_app_id(item->app_id);
-    GtkWidget *icon = gtk_image_new_from_icon_name(icon_name);
+    GtkWidget *icon = gtk_image_new_from_gicon(app_icon_cache_lookup_icon(item->tasklist->icon_cache,
+                                                                         item->app_id));
     gtk_image_set_icon_size(GTK_IMAGE(icon), GTK_ICON_SIZE_NORMAL);
     gtk_box_append(GTK_BOX(box), icon);
-    g_free(icon_name);
+    item->icon = icon;
     
     // Texto del título
     const gchar *display_text = item->title ? item->title : 
@@ -128,6 +235,7 @@ static GtkWidget *create_task_button(TaskItem *item) {
     gtk_label_set_max_width_chars(GTK_LABEL(label), 15);
     gtk_widget_set_hexpand(label, FALSE);
     gtk_box_append(GTK_BOX(box), label);
+    item->label = label;
     
     // Conectar señal de clic
     g_signal_connect(button, "clicked", G_CALLBACK(on_task_button_clicked), item);
@@ -136,9 +244,12 @@ static GtkWidget *create_task_button(TaskItem *item) {
 }
 
 // Crear nuevo item de tarea
-static TaskItem *create_task_item(TasklistWidget *tasklist, const char *app_id, const char *title) {
+static TaskItem *create_task_item(TasklistWidget *tasklist,
+                                  struct zwlr_foreign_toplevel_handle_v1 *toplevel,
+                                  const char *app_id, const char *title) {
     TaskItem *item = g_malloc0(sizeof(TaskItem));
     item->tasklist = tasklist;
+    item->toplevel_handle = toplevel;
     item->app_id = app_id ? g_strdup(app_id) : NULL;
     item->title = title ? g_strdup(title) : NULL;
     item->is_active = FALSE;
@@ -150,9 +261,10 @@ static TaskItem *create_task_item(TasklistWidget *tasklist, const char *app_id,
     // Añadir al contenedor
     gtk_box_append(GTK_BOX(tasklist), item->button);
     
-    // Añadir a la lista
-    tasklist->task_items = g_slist_append(tasklist->task_items, item);
-
+    // Registrar por handle y al final del orden de aparición
+    g_hash_table_insert(tasklist->tasks, toplevel, item);
+    g_queue_push_tail(&tasklist->task_order, item);
+    item->link = tasklist->task_order.tail;
     
     return item;
 }
@@ -161,8 +273,12 @@ static TaskItem *create_task_item(TasklistWidget *tasklist, const char *app_id,
 static void remove_task_item(TasklistWidget *tasklist, TaskItem *item) {
     if (!item) return;
     
-    // Remover de la lista
-    tasklist->task_items = g_slist_remove(tasklist->task_items, item);
+    // Remover del índice y del orden
+    g_hash_table_remove(tasklist->tasks, item->toplevel_handle);
+    g_queue_delete_link(&tasklist->task_order, item->link);
+    if (item->title_dirty) {
+        g_ptr_array_remove_fast(tasklist->dirty_titles, item);
+    }
     
     // Si era la ventana activa, limpiar referencia
     if (tasklist->active_task == item) {
@@ -195,118 +311,97 @@ static void update_task_button_state(TaskItem *item) {
 // Buscar TaskItem por toplevel handle
 static TaskItem *find_task_by_toplevel(TasklistWidget *tasklist, 
                                       struct zwlr_foreign_toplevel_handle_v1 *toplevel) {
-    for (GSList *l = tasklist->task_items; l != NULL; l = l->next) {
-        TaskItem *item = (TaskItem *)l->data;
-        if (item->toplevel_handle == toplevel) {
-            return item;
-        }
-    }
-    return NULL;
-}
-
-// === SISTEMA DE ICONOS DINÁMICO ===
-
-// Buscar archivo .desktop correspondiente al app_id
-static gchar *find_desktop_file(const gchar *app_id) {
-    if (!app_id) return NULL;
-    
-    // Directorios comunes para archivos .desktop
-    const gchar *desktop_dirs[] = {
-        "/usr/share/applications/",
-        "/usr/local/share/applications/",
-        "~/.local/share/applications/",
-        NULL
-    };
-    
-    // Patrones de nombre comunes
-    gchar *patterns[] = {
-        g_strdup_printf("%s.desktop", app_id),
-        g_strdup_printf("org.%s.desktop", app_id),
-        g_strdup_printf("com.%s.desktop", app_id),
-        NULL
-    };
-    
-    for (int d = 0; desktop_dirs[d]; d++) {
-        for (int p = 0; patterns[p]; p++) {
-            gchar *full_path = g_build_filename(desktop_dirs[d], patterns[p], NULL);
-            
-            if (g_file_test(full_path, G_FILE_TEST_EXISTS)) {
-                // Liberar patrones
-                for (int i = 0; patterns[i]; i++) g_free(patterns[i]);
-                return full_path;
-            }
-            
-            g_free(full_path);
-        }
-    }
+    return g_hash_table_lookup(tasklist->tasks, toplevel);
+}
+
+// === ICONOS ===
+
+// Actualizar icono del botón de tarea. La caché ya resuelve el .desktop y
+// lleva application-x-executable de respaldo si el tema no tiene el icono
+static void update_task_button_icon(TaskItem *item) {
+    if (!item || !item->icon) return;
     
-    // Liberar patrones
-    for (int i = 0; patterns[i]; i++) g_free(patterns[i]);
-    return NULL;
+    gtk_image_set_from_gicon(GTK_IMAGE(item->icon),
+                             app_icon_cache_lookup_icon(item->tasklist->icon_cache, item->app_id));
 }
 
-// Extraer nombre de icono de archivo .desktop
-static gchar *extract_icon_from_desktop_file(const gchar *desktop_path) {
-    GKeyFile *key_file = g_key_file_new();
-    GError *error = NULL;
-    gchar *icon_name = NULL;
+// Ha cambiado algún .desktop: volver a resolver todos los iconos
+static void on_icon_cache_changed(AppIconCache *cache G_GNUC_UNUSED, gpointer user_data) {
+    TasklistWidget *tasklist = TASKLIST_WIDGET(user_data);
     
-    if (g_key_file_load_from_file(key_file, desktop_path, G_KEY_FILE_NONE, &error)) {
-        icon_name = g_key_file_get_string(key_file, "Desktop Entry", "Icon", NULL);
-    } else {
-        g_debug("Error leyendo %s: %s", desktop_path, error->message);
-        g_error_free(error);
+    for (GList *l = tasklist->task_order.head; l; l = l->next) {
+        update_task_button_icon(l->data);
     }
-    
-    g_key_file_free(key_file);
-    return icon_name;
 }
 
-// Función principal para obtener nombre de icono - 100% dinámico
-static gchar *get_icon_name_for_app_id(const gchar *app_id) {
-    if (!app_id) return g_strdup("application-x-executable");
+// === TÍTULOS COALESCIDOS POR FRAME ===
+
+static gboolean flush_task_titles(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data);
+
+static void schedule_title_flush(TasklistWidget *tasklist) {
+    if (tasklist->title_tick_id == 0) {
+        tasklist->title_tick_id = gtk_widget_add_tick_callback(GTK_WIDGET(tasklist),
+                                                               flush_task_titles, NULL, NULL);
+    }
+}
+
+static gboolean on_title_timeout(gpointer user_data) {
+    TasklistWidget *tasklist = TASKLIST_WIDGET(user_data);
     
-    // 1. Buscar archivo .desktop de la aplicación
-    gchar *desktop_file = find_desktop_file(app_id);
-    if (desktop_file) {
-        gchar *icon_name = extract_icon_from_desktop_file(desktop_file);
-        g_free(desktop_file);
+    tasklist->title_timeout_id = 0;
+    schedule_title_flush(tasklist);
+    return G_SOURCE_REMOVE;
+}
+
+// Pintar los títulos pendientes que ya tocan. Cada gtk_label_set_text
+// recalcula el tamaño de todo el panel, así que una terminal con una barra
+// de progreso en el título no debe pedir más de un relayout por frame
+static gboolean flush_task_titles(GtkWidget *widget, GdkFrameClock *frame_clock,
+                                  gpointer user_data G_GNUC_UNUSED) {
+    TasklistWidget *self = TASKLIST_WIDGET(widget);
+    gint64 now = gdk_frame_clock_get_frame_time(frame_clock);
+    gint rate = self->config ? self->config->tasklist_background_title_rate : 0;
+    gint64 min_gap = rate > 0 ? G_USEC_PER_SEC / rate : 0;
+    gint64 next_due = G_MAXINT64;
+    
+    for (guint i = 0; i < self->dirty_titles->len;) {
+        TaskItem *item = g_ptr_array_index(self->dirty_titles, i);
         
-        if (icon_name && strlen(icon_name) > 0) {
-            return icon_name;
+        // La ventana activa siempre al día; las demás esperan su turno
+        gint64 due = item->is_active ? 0 : item->title_shown_time + min_gap;
+        if (due > now) {
+            next_due = MIN(next_due, due);
+            i++;
+            continue;
         }
-        g_free(icon_name);
+        
+        gtk_label_set_text(GTK_LABEL(item->label), item->title);
+        item->title_shown_time = now;
+        item->title_dirty = FALSE;
+        g_ptr_array_remove_index_fast(self->dirty_titles, i);
+    }
+    
+    self->title_tick_id = 0;
+    
+    // Sin un tick por frame mientras se espera: un temporizador lo reactiva
+    if (self->title_timeout_id > 0) {
+        g_source_remove(self->title_timeout_id);
+        self->title_timeout_id = 0;
+    }
+    if (self->dirty_titles->len > 0) {
+        guint delay_ms = (guint)((next_due - now + 999) / 1000);
+        self->title_timeout_id = g_timeout_add(delay_ms, on_title_timeout, self);
     }
     
-    // 2. Usar app_id directamente (muchas apps usan su app_id como nombre de icono)
-    return g_strdup(app_id);
+    return G_SOURCE_REMOVE;
 }
 
-// Actualizar icono del botón de tarea
-static void update_task_button_icon(TaskItem *item) {
-    if (!item || !item->button) return;
-    
-    // Obtener nombre de icono
-    gchar *icon_name = get_icon_name_for_app_id(item->app_id);
-    
-    // Encontrar el widget de icono en el botón
-    GtkWidget *button_child = gtk_button_get_child(GTK_BUTTON(item->button));
-    if (GTK_IS_BOX(button_child)) {
-        GtkWidget *icon_widget = gtk_widget_get_first_child(button_child);
-        if (GTK_IS_IMAGE(icon_widget)) {
-            // Verificar si el icono existe en el tema
-            GtkIconTheme *icon_theme = gtk_icon_theme_get_for_display(gdk_display_get_default());
-            
-            if (gtk_icon_theme_has_icon(icon_theme, icon_name)) {
-                gtk_image_set_from_icon_name(GTK_IMAGE(icon_widget), icon_name);
-            } else {
-                // Fallback a icono genérico
-                gtk_image_set_from_icon_name(GTK_IMAGE(icon_widget), "application-x-executable");
-            }
-        }
+static void queue_title_update(TaskItem *item) {
+    if (!item->title_dirty) {
+        item->title_dirty = TRUE;
+        g_ptr_array_add(item->tasklist->dirty_titles, item);
     }
-    
-    g_free(icon_name);
+    schedule_title_flush(item->tasklist);
 }
 
 // === CALLBACKS DEL PROTOCOLO WAYLAND ===
@@ -319,15 +414,9 @@ static void toplevel_handle_title(void *data,
     TaskItem *item = find_task_by_toplevel(tasklist, toplevel);
     
     if (item) {
-        g_free(item->title);
-        item->title = g_strdup(title);
-        
-        // Actualizar texto del botón
-        GtkWidget *box = gtk_button_get_child(GTK_BUTTON(item->button));
-        GtkWidget *label = gtk_widget_get_last_child(box);
-        if (GTK_IS_LABEL(label)) {
-            gtk_label_set_text(GTK_LABEL(label), title);
-        }
+        g_free(item->pending_title);
+        item->pending_title = g_strdup(title);
+        item->changes |= TASK_CHANGED_TITLE;
     }
 }
 
@@ -339,11 +428,9 @@ static void toplevel_handle_app_id(void *data,
     TaskItem *item = find_task_by_toplevel(tasklist, toplevel);
     
     if (item) {
-        g_free(item->app_id);
-        item->app_id = g_strdup(app_id);
-        
-        // Actualizar icono cuando recibimos el app_id
-        update_task_button_icon(item);
+        g_free(item->pending_app_id);
+        item->pending_app_id = g_strdup(app_id);
+        item->changes |= TASK_CHANGED_APP_ID;
     }
 }
 
@@ -357,30 +444,87 @@ static void toplevel_handle_state(void *data,
     if (!item) return;
     
     // Resetear estados
-    item->is_active = FALSE;
-    item->is_minimized = FALSE;
+    item->pending_active = FALSE;
+    item->pending_minimized = FALSE;
     
     // Procesar nuevos estados
     uint32_t *entry;
     wl_array_for_each(entry, state) {
         switch (*entry) {
         case ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_ACTIVATED:
-            item->is_active = TRUE;
+            item->pending_active = TRUE;
             break;
         case ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_MINIMIZED:
-            item->is_minimized = TRUE;
+            item->pending_minimized = TRUE;
             break;
         }
     }
     
-    // Actualizar UI
-    update_task_button_state(item);
+    item->changes |= TASK_CHANGED_STATE;
 }
 
-// Callback: configuración completada
-static void toplevel_handle_done(void *data G_GNUC_UNUSED,
-                                struct zwlr_foreign_toplevel_handle_v1 *toplevel G_GNUC_UNUSED) {
-    // Configuración de ventana completada, no necesitamos hacer nada especial
+// Callback: configuración completada. Aplicar de una vez todo lo recibido
+// desde el `done` anterior: un solo relayout por lote y sin estados
+// intermedios (título nuevo con el estado viejo) en pantalla
+static void toplevel_handle_done(void *data,
+                                struct zwlr_foreign_toplevel_handle_v1 *toplevel) {
+    TasklistWidget *tasklist = TASKLIST_WIDGET(data);
+    TaskItem *item = find_task_by_toplevel(tasklist, toplevel);
+    
+    if (!item) return;
+    
+    // Un clic se mide contra el primer lote que trae el estado: los anteriores
+    // pueden ser cambios de título que ya estaban en camino. Si ese lote no
+    // cambia el estado, el compositor no aplicó el clic; y pasado
+    // CLICK_LATENCY_TIMEOUT tampoco se le atribuye un cambio posterior
+    gint64 click_time = 0;
+    if (item->click_time > 0 &&
+        g_get_monotonic_time() - item->click_time > CLICK_LATENCY_TIMEOUT) {
+        item->click_time = 0;
+    }
+    if (item->changes & TASK_CHANGED_STATE) {
+        click_time = item->click_time;
+        item->click_time = 0;
+    }
+    
+    if (!item->changes) return;
+    
+    // Solo se toca el widget si el valor ha cambiado de verdad
+    if ((item->changes & TASK_CHANGED_TITLE) && g_strcmp0(item->title, item->pending_title) != 0) {
+        g_free(item->title);
+        item->title = g_steal_pointer(&item->pending_title);
+        
+        // El texto del botón se actualiza en el siguiente frame
+        queue_title_update(item);
+    }
+    
+    if ((item->changes & TASK_CHANGED_APP_ID) && g_strcmp0(item->app_id, item->pending_app_id) != 0) {
+        g_free(item->app_id);
+        item->app_id = g_steal_pointer(&item->pending_app_id);
+        
+        // Actualizar icono cuando recibimos el app_id
+        update_task_button_icon(item);
+    }
+    
+    if ((item->changes & TASK_CHANGED_STATE) &&
+        (item->is_active != item->pending_active || item->is_minimized != item->pending_minimized)) {
+        item->is_active = item->pending_active;
+        item->is_minimized = item->pending_minimized;
+        update_task_button_state(item);
+        
+        if (click_time > 0) {
+            record_click_latency(item, click_time);
+        }
+        
+        // Al pasar a primer plano, su título retenido no espera más
+        if (item->is_active && item->title_dirty) {
+            schedule_title_flush(tasklist);
+        }
+    }
+    
+    g_clear_pointer(&item->pending_title, g_free);
+    g_clear_pointer(&item->pending_app_id, g_free);
+    item->changes = 0;
 }
 
 // Callback: ventana cerrada
@@ -418,8 +562,7 @@ static void toplevel_manager_handle_toplevel(void *data,
     TasklistWidget *tasklist = TASKLIST_WIDGET(data);
     
     // Crear item temporal (título y app_id llegarán después)
-    TaskItem *item = create_task_item(tasklist, NULL, "Cargando...");
-    item->toplevel_handle = toplevel;
+    create_task_item(tasklist, toplevel, NULL, "Cargando...");
     
     // Añadir listener a esta ventana
     zwlr_foreign_toplevel_handle_v1_add_listener(toplevel, &toplevel_handle_listener, tasklist);
@@ -539,9 +682,24 @@ static gboolean wayland_event_callback(GIOChannel *channel G_GNUC_UNUSED, GIOCon
     TasklistWidget *self = TASKLIST_WIDGET(user_data);
     
     if (condition & G_IO_IN) {
-        // Procesar eventos pendientes sin bloquear
-        if (wl_display_dispatch(self->wl_display) == -1) {
-
+        // Leer y despachar sin bloquear. wl_display_dispatch vaciaría antes el
+        // buffer de salida y se quedaría esperando con el socket lleno
+        while (wl_display_prepare_read(self->wl_display) != 0) {
+            if (wl_display_dispatch_pending(self->wl_display) == -1) {
+                return G_SOURCE_REMOVE;
+            }
+        }
+        
+        // Hay datos (G_IO_IN) y el socket de libwayland no bloquea
+        if (wl_display_read_events(self->wl_display) == -1 ||
+            wl_display_dispatch_pending(self->wl_display) == -1) {
+            g_warning("Error leyendo eventos del compositor: %s", g_strerror(errno));
+            return G_SOURCE_REMOVE;
+        }
+        
+        // Lo que pidan los callbacks sale sin esperar; si el socket está
+        // lleno, el watch de escritura lo envía después
+        if (!flush_wayland_requests(self)) {
             return G_SOURCE_REMOVE;
         }
     }
@@ -613,9 +771,52 @@ static void apply_tasklist_styles(void) {
     styles_applied = TRUE;
 }
 
+static void tasklist_widget_dispose(GObject *object) {
+    TasklistWidget *self = TASKLIST_WIDGET(object);
+    
+    if (self->icon_cache) {
+        g_signal_handler_disconnect(self->icon_cache, self->icon_cache_handler);
+        self->icon_cache = NULL;
+    }
+    
+    if (self->title_tick_id > 0) {
+        gtk_widget_remove_tick_callback(GTK_WIDGET(self), self->title_tick_id);
+        self->title_tick_id = 0;
+    }
+    
+    if (self->title_timeout_id > 0) {
+        g_source_remove(self->title_timeout_id);
+        self->title_timeout_id = 0;
+    }
+    
+#ifdef HAVE_WLR_PROTOCOLS
+    if (self->flush_watch_id > 0) {
+        g_source_remove(self->flush_watch_id);
+        self->flush_watch_id = 0;
+    }
+    
+    while (!g_queue_is_empty(&self->task_order)) {
+        remove_task_item(self, g_queue_peek_head(&self->task_order));
+    }
+#endif
+    
+    G_OBJECT_CLASS(tasklist_widget_parent_class)->dispose(object);
+}
+
+static void tasklist_widget_finalize(GObject *object) {
+    TasklistWidget *self = TASKLIST_WIDGET(object);
+    
+    g_hash_table_destroy(self->tasks);
+    g_ptr_array_free(self->dirty_titles, TRUE);
+    
+    G_OBJECT_CLASS(tasklist_widget_parent_class)->finalize(object);
+}
+
 // Inicialización de la clase
-static void tasklist_widget_class_init(TasklistWidgetClass *class G_GNUC_UNUSED) {
-    // Configuración de la clase (destructor, etc.)
+static void tasklist_widget_class_init(TasklistWidgetClass *class) {
+    GObjectClass *object_class = G_OBJECT_CLASS(class);
+    object_class->dispose = tasklist_widget_dispose;
+    object_class->finalize = tasklist_widget_finalize;
 }
 
 // Inicialización de la instancia  
@@ -635,7 +836,15 @@ static void tasklist_widget_init(TasklistWidget *self) {
     apply_tasklist_styles();
     
     // Inicializar listas y conexión Wayland como NULL
-    self->task_items = NULL;
+    self->tasks = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_queue_init(&self->task_order);
+    self->dirty_titles = g_ptr_array_new();
+    
+#ifdef HAVE_WLR_PROTOCOLS
+    self->icon_cache = app_icon_cache_get_default();
+    self->icon_cache_handler = g_signal_connect(self->icon_cache, "changed",
+                                                G_CALLBACK(on_icon_cache_changed), self);
+#endif
     self->active_task = NULL;
     
 #ifdef HAVE_WLR_PROTOCOLS
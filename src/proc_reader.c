@@ -0,0 +1,137 @@
+#define _GNU_SOURCE
+#include "proc_reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define PROC_FILE_INITIAL_SIZE 4096
+
+ProcFile *proc_file_open(const gchar *path) {
+    return proc_file_open_sized(path, PROC_FILE_INITIAL_SIZE);
+}
+
+ProcFile *proc_file_open_sized(const gchar *path, gsize capacity) {
+    g_return_val_if_fail(capacity > 0, NULL);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        g_debug("No se pudo abrir %s: %s", path, g_strerror(errno));
+        return NULL;
+    }
+
+    ProcFile *file = g_malloc0(sizeof(ProcFile));
+    file->path = g_strdup(path);
+    file->fd = fd;
+    file->capacity = capacity;
+    file->buffer = g_malloc(file->capacity + 1);
+
+    return file;
+}
+
+void proc_file_close(ProcFile *file) {
+    if (!file) return;
+
+    if (file->fd >= 0) {
+        close(file->fd);
+    }
+
+    g_free(file->path);
+    g_free(file->buffer);
+    g_free(file);
+}
+
+const gchar *proc_file_read(ProcFile *file, gsize *length) {
+    gsize total = 0;
+
+    for (;;) {
+        // El archivo ya no cabe: duplicar el buffer y seguir leyendo
+        if (total == file->capacity) {
+            file->capacity *= 2;
+            file->buffer = g_realloc(file->buffer, file->capacity + 1);
+        }
+
+        gssize n = pread(file->fd, file->buffer + total, file->capacity - total, (off_t)total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            g_debug("Error leyendo %s: %s", file->path, g_strerror(errno));
+            return NULL;
+        }
+
+        // seq_file entrega como mucho una página por llamada y sin partir
+        // registros, así que una lectura corta no indica el final: solo 0 lo hace
+        if (n == 0) break;
+
+        total += (gsize)n;
+    }
+
+    file->buffer[total] = '\0';
+    if (length) *length = total;
+
+    return file->buffer;
+}
+
+static gboolean line_has_key(const gchar *line, const gchar *key, gsize key_len) {
+    return strncmp(line, key, key_len) == 0 && line[key_len] == ':';
+}
+
+void proc_parse_meminfo(const gchar *data, ProcMeminfo *info) {
+    guint found = 0;
+
+    memset(info, 0, sizeof(ProcMeminfo));
+
+    // Las claves que nos interesan van antes de "Dirty"; paramos al tenerlas
+    // todas o al llegar ahí (los kernels sin zswap no tienen las dos últimas)
+    for (const gchar *line = data; line && found < 9 && line[0] != 'D'; line = proc_next_line(line)) {
+        guint64 *target = NULL;
+        gsize key_len = 0;
+
+        switch (line[0]) {
+        case 'M':
+            if (line_has_key(line, "MemTotal", 8)) { target = &info->mem_total; key_len = 8; }
+            else if (line_has_key(line, "MemFree", 7)) { target = &info->mem_free; key_len = 7; }
+            else if (line_has_key(line, "MemAvailable", 12)) { target = &info->mem_available; key_len = 12; }
+            break;
+        case 'B':
+            if (line_has_key(line, "Buffers", 7)) { target = &info->buffers; key_len = 7; }
+            break;
+        case 'C':
+            if (line_has_key(line, "Cached", 6)) { target = &info->cached; key_len = 6; }
+            break;
+        case 'S':
+            if (line_has_key(line, "SwapTotal", 9)) { target = &info->swap_total; key_len = 9; }
+            else if (line_has_key(line, "SwapFree", 8)) { target = &info->swap_free; key_len = 8; }
+            break;
+        case 'Z':
+            if (line_has_key(line, "Zswap", 5)) { target = &info->zswap; key_len = 5; }
+            else if (line_has_key(line, "Zswapped", 8)) { target = &info->zswapped; key_len = 8; }
+            break;
+        }
+
+        if (target) {
+            proc_parse_u64(line + key_len + 1, target);
+            found++;
+        }
+    }
+}
+
+void proc_parse_net_dev(const gchar *data, ProcNetDevFunc func, gpointer user_data) {
+    // Saltar las dos primeras líneas (headers)
+    const gchar *line = proc_next_line(data);
+    line = line ? proc_next_line(line) : NULL;
+
+    for (; line; line = proc_next_line(line)) {
+        // Formato: "  iface: rx_bytes rx_packets ... (8 campos) tx_bytes ..."
+        const gchar *name = proc_skip_spaces(line);
+        const gchar *colon = strchr(name, ':');
+        if (!colon) break;
+
+        guint64 rx_bytes, tx_bytes, dummy;
+        const gchar *p = proc_parse_u64(colon + 1, &rx_bytes);
+        for (int i = 0; i < 7; i++) {
+            p = proc_parse_u64(p, &dummy);
+        }
+        proc_parse_u64(p, &tx_bytes);
+
+        func(name, colon - name, rx_bytes, tx_bytes, user_data);
+    }
+}
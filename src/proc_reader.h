@@ -0,0 +1,113 @@
+#pragma once
+
+#include <glib.h>
+#include <string.h>
+
+G_BEGIN_DECLS
+
+// Archivo de /proc (o /sys) con el descriptor abierto de forma persistente.
+// Cada lectura usa pread() desde el offset 0 sobre un buffer propio que solo
+// crece si el archivo deja de caber, así una muestra no reserva memoria.
+typedef struct {
+    gchar *path;
+    int fd;
+    gchar *buffer;
+    gsize capacity;
+} ProcFile;
+
+ProcFile *proc_file_open(const gchar *path);
+
+// Con un buffer inicial de `capacity` bytes: para atributos de /sys de unos
+// pocos bytes, donde la página de proc_file_open sobra
+ProcFile *proc_file_open_sized(const gchar *path, gsize capacity);
+void proc_file_close(ProcFile *file);
+
+// Devuelve el contenido terminado en NUL (válido hasta la siguiente lectura)
+const gchar *proc_file_read(ProcFile *file, gsize *length);
+
+// --- Parsers especializados para el formato de /proc ---
+
+static inline const gchar *proc_skip_spaces(const gchar *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// Entero sin signo en base 10; ignora los espacios iniciales
+static inline const gchar *proc_parse_u64(const gchar *p, guint64 *value) {
+    guint64 v = 0;
+
+    p = proc_skip_spaces(p);
+    while ((guint)(*p - '0') < 10) {
+        v = v * 10 + (guint)(*p - '0');
+        p++;
+    }
+
+    *value = v;
+    return p;
+}
+
+// Decimal sin signo con parte fraccionaria opcional ("12.34", formato de /proc/pressure)
+static inline const gchar *proc_parse_decimal(const gchar *p, double *value) {
+    guint64 integer;
+    double scale = 0.1;
+
+    p = proc_parse_u64(p, &integer);
+    double v = (double)integer;
+
+    if (*p == '.') {
+        p++;
+        while ((guint)(*p - '0') < 10) {
+            v += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+        }
+    }
+
+    *value = v;
+    return p;
+}
+
+// Inicio de la línea siguiente o NULL al final del buffer
+static inline const gchar *proc_next_line(const gchar *p) {
+    const gchar *newline = strchr(p, '\n');
+    return newline ? newline + 1 : NULL;
+}
+
+// Los 8 contadores de una línea cpu de /proc/stat (tras "cpu" o "cpuN"):
+// total e idle (idle + iowait)
+static inline const gchar *proc_parse_cpu_line(const gchar *p, guint64 *total, guint64 *idle) {
+    // user nice system idle iowait irq softirq steal
+    guint64 fields[8];
+    for (int i = 0; i < 8; i++) {
+        p = proc_parse_u64(p, &fields[i]);
+    }
+
+    *total = fields[0] + fields[1] + fields[2] + fields[3] +
+             fields[4] + fields[5] + fields[6] + fields[7];
+    *idle = fields[3] + fields[4];
+    return p;
+}
+
+// Claves de /proc/meminfo que usa el monitor, en kB; 0 si faltan
+typedef struct {
+    guint64 mem_total;
+    guint64 mem_free;
+    guint64 mem_available;
+    guint64 buffers;
+    guint64 cached;
+    guint64 swap_total;
+    guint64 swap_free;
+    guint64 zswap;
+    guint64 zswapped;
+} ProcMeminfo;
+
+void proc_parse_meminfo(const gchar *data, ProcMeminfo *info);
+
+// Llamar a `func` por cada interfaz de /proc/net/dev con sus bytes recibidos
+// y enviados; el nombre no termina en NUL
+typedef void (*ProcNetDevFunc)(const gchar *name, gsize name_len,
+                               guint64 rx_bytes, guint64 tx_bytes, gpointer user_data);
+
+void proc_parse_net_dev(const gchar *data, ProcNetDevFunc func, gpointer user_data);
+
+G_END_DECLS
@@ -0,0 +1,220 @@
+#include "process_popover.h"
+#include "i18n.h"
+#include "timebase.h"
+
+#define PROCESS_POPOVER_ROWS 8
+#define PROCESS_POPOVER_INTERVAL_MS 1000
+#define PROCESS_POPOVER_TOLERANCE_MS 250
+
+typedef struct {
+    GtkWidget *name;
+    GtkWidget *cpu;
+    GtkWidget *memory;
+} ProcessRow;
+
+struct _ProcessPopover {
+    GtkPopover parent_instance;
+
+    ProcessSortKey key;
+    ProcessRow rows[PROCESS_POPOVER_ROWS];
+
+    // NULL mientras un recorrido lo tiene en el hilo de trabajo
+    ProcessScanner *scanner;
+    gboolean scanning;
+    gboolean has_baseline;
+    guint timer_id;
+};
+
+G_DEFINE_TYPE(ProcessPopover, process_popover, GTK_TYPE_POPOVER)
+
+// Un recorrido en curso: el scanner viaja con él y vuelve al terminar
+typedef struct {
+    ProcessScanner *scanner;
+    ProcessSortKey key;
+    ProcessInfo top[PROCESS_POPOVER_ROWS];
+    guint count;
+} ScanJob;
+
+static void scan_job_free(gpointer data) {
+    ScanJob *job = data;
+
+    process_scanner_free(job->scanner);
+    g_free(job);
+}
+
+static void scan_thread(GTask *task, gpointer source_object G_GNUC_UNUSED,
+                        gpointer task_data, GCancellable *cancellable G_GNUC_UNUSED) {
+    ScanJob *job = task_data;
+
+    if (!job->scanner) {
+        job->scanner = process_scanner_new();
+    }
+    if (job->scanner) {
+        job->count = process_scanner_scan(job->scanner, job->key, job->top, PROCESS_POPOVER_ROWS);
+    }
+
+    g_task_return_boolean(task, job->scanner != NULL);
+}
+
+static void update_rows(ProcessPopover *self, const ScanJob *job) {
+    for (guint i = 0; i < PROCESS_POPOVER_ROWS; i++) {
+        ProcessRow *row = &self->rows[i];
+        gboolean visible = i < job->count;
+
+        gtk_widget_set_visible(row->name, visible);
+        gtk_widget_set_visible(row->cpu, visible && self->key == PROCESS_SORT_CPU);
+        gtk_widget_set_visible(row->memory, visible);
+        if (!visible) continue;
+
+        const ProcessInfo *info = &job->top[i];
+        gchar *text;
+
+        gtk_label_set_text(GTK_LABEL(row->name), info->name);
+
+        text = g_strdup_printf("%.1f%%", info->cpu_percent);
+        gtk_label_set_text(GTK_LABEL(row->cpu), text);
+        g_free(text);
+
+        text = g_format_size(info->rss_kb * 1024);
+        gtk_label_set_text(GTK_LABEL(row->memory), text);
+        g_free(text);
+    }
+}
+
+static void on_scan_done(GObject *source, GAsyncResult *result, gpointer user_data G_GNUC_UNUSED) {
+    ProcessPopover *self = PROCESS_POPOVER(source);
+    ScanJob *job = g_task_get_task_data(G_TASK(result));
+
+    self->scanning = FALSE;
+    if (!g_task_propagate_boolean(G_TASK(result), NULL)) return;
+
+    // Cerrado durante el recorrido: el scanner se libera con el job
+    if (!gtk_widget_get_mapped(GTK_WIDGET(self))) return;
+
+    self->scanner = g_steal_pointer(&job->scanner);
+
+    // El primer recorrido de CPU no tiene con qué comparar
+    if (self->key == PROCESS_SORT_CPU && !self->has_baseline) {
+        self->has_baseline = TRUE;
+        return;
+    }
+    update_rows(self, job);
+}
+
+static void start_scan(ProcessPopover *self) {
+    // Si el anterior aún no ha terminado se salta este tick
+    if (self->scanning) return;
+
+    ScanJob *job = g_new0(ScanJob, 1);
+    job->scanner = g_steal_pointer(&self->scanner);
+    job->key = self->key;
+
+    GTask *task = g_task_new(self, NULL, on_scan_done, NULL);
+    g_task_set_task_data(task, job, scan_job_free);
+    g_task_run_in_thread(task, scan_thread);
+    g_object_unref(task);
+
+    self->scanning = TRUE;
+}
+
+static gboolean on_refresh(gpointer user_data) {
+    start_scan(PROCESS_POPOVER(user_data));
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_map(GtkWidget *widget, gpointer user_data G_GNUC_UNUSED) {
+    ProcessPopover *self = PROCESS_POPOVER(widget);
+
+    start_scan(self);
+    self->timer_id = timebase_add(PROCESS_POPOVER_INTERVAL_MS, PROCESS_POPOVER_TOLERANCE_MS,
+                                  on_refresh, self);
+}
+
+// Oculto no se recorre nada ni se mantienen abiertos los archivos de /proc
+static void on_unmap(GtkWidget *widget, gpointer user_data G_GNUC_UNUSED) {
+    ProcessPopover *self = PROCESS_POPOVER(widget);
+
+    if (self->timer_id > 0) {
+        timebase_remove(self->timer_id);
+        self->timer_id = 0;
+    }
+
+    g_clear_pointer(&self->scanner, process_scanner_free);
+    self->has_baseline = FALSE;
+}
+
+static GtkWidget *add_label(GtkGrid *grid, const gchar *text, int column, int row, float xalign) {
+    GtkWidget *label = gtk_label_new(text);
+    gtk_label_set_xalign(GTK_LABEL(label), xalign);
+    gtk_grid_attach(grid, label, column, row, 1, 1);
+    return label;
+}
+
+static void process_popover_dispose(GObject *object) {
+    ProcessPopover *self = PROCESS_POPOVER(object);
+
+    if (self->timer_id > 0) {
+        timebase_remove(self->timer_id);
+        self->timer_id = 0;
+    }
+
+    g_clear_pointer(&self->scanner, process_scanner_free);
+
+    G_OBJECT_CLASS(process_popover_parent_class)->dispose(object);
+}
+
+static void process_popover_init(ProcessPopover *self) {
+    gtk_popover_set_position(GTK_POPOVER(self), GTK_POS_TOP);
+    gtk_popover_set_autohide(GTK_POPOVER(self), TRUE);
+    gtk_popover_set_has_arrow(GTK_POPOVER(self), FALSE);
+    gtk_widget_add_css_class(GTK_WIDGET(self), "process-popover");
+
+    g_signal_connect(self, "map", G_CALLBACK(on_map), NULL);
+    g_signal_connect(self, "unmap", G_CALLBACK(on_unmap), NULL);
+}
+
+static void process_popover_build(ProcessPopover *self) {
+    GtkGrid *grid = GTK_GRID(gtk_grid_new());
+    gboolean show_cpu = self->key == PROCESS_SORT_CPU;
+
+    gtk_grid_set_column_spacing(grid, 12);
+    gtk_grid_set_row_spacing(grid, 2);
+
+    GtkWidget *header = add_label(grid, _("Process"), 0, 0, 0.0f);
+    gtk_widget_add_css_class(header, "process-popover-header");
+    if (show_cpu) {
+        header = add_label(grid, "CPU", 1, 0, 1.0f);
+        gtk_widget_add_css_class(header, "process-popover-header");
+    }
+    header = add_label(grid, _("Memory"), 2, 0, 1.0f);
+    gtk_widget_add_css_class(header, "process-popover-header");
+
+    // Las etiquetas se crean una vez y se reutilizan en cada recorrido
+    for (guint i = 0; i < PROCESS_POPOVER_ROWS; i++) {
+        ProcessRow *row = &self->rows[i];
+
+        row->name = add_label(grid, NULL, 0, i + 1, 0.0f);
+        row->cpu = add_label(grid, NULL, 1, i + 1, 1.0f);
+        row->memory = add_label(grid, NULL, 2, i + 1, 1.0f);
+        gtk_widget_add_css_class(row->cpu, "numeric");
+        gtk_widget_add_css_class(row->memory, "numeric");
+
+        gtk_widget_set_visible(row->name, FALSE);
+        gtk_widget_set_visible(row->cpu, FALSE);
+        gtk_widget_set_visible(row->memory, FALSE);
+    }
+
+    gtk_popover_set_child(GTK_POPOVER(self), GTK_WIDGET(grid));
+}
+
+static void process_popover_class_init(ProcessPopoverClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = process_popover_dispose;
+}
+
+GtkWidget *process_popover_new(ProcessSortKey key) {
+    ProcessPopover *self = g_object_new(PROCESS_TYPE_POPOVER, NULL);
+    self->key = key;
+    process_popover_build(self);
+    return GTK_WIDGET(self);
+}
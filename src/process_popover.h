@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "process_scanner.h"
+
+G_BEGIN_DECLS
+
+// Popover con los procesos que más CPU o memoria usan. Solo recorre /proc
+// mientras está visible, en un hilo aparte, y libera el estado al cerrarse.
+#define PROCESS_TYPE_POPOVER (process_popover_get_type())
+G_DECLARE_FINAL_TYPE(ProcessPopover, process_popover, PROCESS, POPOVER, GtkPopover)
+
+// Con PROCESS_SORT_MEMORY no se muestra la columna de CPU
+GtkWidget *process_popover_new(ProcessSortKey key);
+
+G_END_DECLS
@@ -0,0 +1,333 @@
+#define _GNU_SOURCE
+#include "process_scanner.h"
+#include "proc_reader.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+// /proc/[pid]/stat ocupa unos 300 bytes; schedstat y statm menos de 100
+#define STAT_BUFFER_SIZE 1024
+
+// Reservar la mitad del límite de descriptores para el resto del panel
+#define FD_BUDGET_DIVISOR 2
+
+typedef struct {
+    ProcessInfo info;
+    int fd;                 // archivo de la clave abierto de forma persistente, o -1
+    guint64 value;          // lectura anterior: ns de CPU o páginas residentes
+    guint64 generation;     // último recorrido en el que apareció
+} ProcessState;
+
+struct _ProcessScanner {
+    DIR *dir;
+    int proc_fd;
+
+    // pid → ProcessState
+    GHashTable *processes;
+    guint64 generation;
+    gint64 prev_time;
+
+    // Clave del último recorrido: decide qué archivo tienen abierto los estados
+    ProcessSortKey key;
+    guint open_fds;
+    guint fd_budget;
+
+    // Sin CONFIG_SCHED_INFO no hay schedstat y la CPU sale de stat (en ticks)
+    gboolean has_schedstat;
+    long clock_ticks;
+    long page_kb;
+
+    gchar buffer[STAT_BUFFER_SIZE];
+};
+
+ProcessScanner *process_scanner_new(void) {
+    DIR *dir = opendir("/proc");
+    if (!dir) {
+        g_warning("No se pudo abrir /proc: %s", g_strerror(errno));
+        return NULL;
+    }
+
+    ProcessScanner *scanner = g_malloc0(sizeof(ProcessScanner));
+    scanner->dir = dir;
+    scanner->proc_fd = dirfd(dir);
+    scanner->processes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    scanner->has_schedstat = faccessat(scanner->proc_fd, "self/schedstat", R_OK, 0) == 0;
+    scanner->clock_ticks = MAX(sysconf(_SC_CLK_TCK), 1);
+    scanner->page_kb = MAX(sysconf(_SC_PAGESIZE) / 1024, 1);
+
+    // Más allá del presupuesto los archivos se abren y cierran en cada recorrido
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        scanner->fd_budget = (guint)MIN(limit.rlim_cur / FD_BUDGET_DIVISOR, G_MAXUINT);
+    } else {
+        scanner->fd_budget = 1024 / FD_BUDGET_DIVISOR;
+    }
+
+    return scanner;
+}
+
+static void process_state_close(ProcessScanner *scanner, ProcessState *state) {
+    if (state->fd >= 0) {
+        close(state->fd);
+        state->fd = -1;
+        scanner->open_fds--;
+    }
+}
+
+static void close_all(ProcessScanner *scanner) {
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, scanner->processes);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        process_state_close(scanner, value);
+    }
+}
+
+void process_scanner_free(ProcessScanner *scanner) {
+    if (!scanner) return;
+
+    close_all(scanner);
+    closedir(scanner->dir);
+    g_hash_table_destroy(scanner->processes);
+    g_free(scanner);
+}
+
+// Saltar `count` campos separados por espacios (algunos pueden ser negativos)
+static const gchar *skip_fields(const gchar *p, guint count) {
+    while (count-- > 0) {
+        p = proc_skip_spaces(p);
+        while (*p && *p != ' ') p++;
+    }
+    return p;
+}
+
+// /proc/[pid]/stat: "pid (comm) estado ..."; el comm puede contener espacios y
+// paréntesis, así que los campos se cuentan desde el último ')'. Devuelve el
+// primer campo tras el comm (el 3) o NULL
+static const gchar *parse_stat_comm(const gchar *data, gchar *name, gsize name_size) {
+    const gchar *open = strchr(data, '(');
+    const gchar *close_paren = strrchr(data, ')');
+    if (!open || !close_paren || close_paren < open) return NULL;
+
+    if (name) {
+        gsize name_len = MIN((gsize)(close_paren - open - 1), name_size - 1);
+        memcpy(name, open + 1, name_len);
+        name[name_len] = '\0';
+    }
+    return close_paren + 1;
+}
+
+// utime + stime (campos 14 y 15) y rss en páginas (campo 24)
+static void parse_stat_fields(const gchar *fields, guint64 *cpu_ticks, guint64 *rss_pages) {
+    guint64 utime, stime;
+    const gchar *p = skip_fields(fields, 11);
+
+    p = proc_parse_u64(p, &utime);
+    p = proc_parse_u64(p, &stime);
+    p = skip_fields(p, 8);
+    proc_parse_u64(p, rss_pages);
+    *cpu_ticks = utime + stime;
+}
+
+static const gchar *key_file(ProcessScanner *scanner, ProcessSortKey key) {
+    if (key == PROCESS_SORT_MEMORY) return "statm";
+    return scanner->has_schedstat ? "schedstat" : "stat";
+}
+
+// Leer un archivo del proceso en el buffer; con `keep` se deja abierto en *fd,
+// salvo si la lectura falla (el proceso terminó entre openat y pread)
+static gboolean read_process_file(ProcessScanner *scanner, const gchar *pid_name, const gchar *file,
+                                  int *fd, gboolean keep) {
+    if (*fd < 0) {
+        gchar path[NAME_MAX + sizeof("/schedstat")];
+        g_snprintf(path, sizeof(path), "%s/%s", pid_name, file);
+
+        *fd = openat(scanner->proc_fd, path, O_RDONLY | O_CLOEXEC);
+        if (*fd < 0) return FALSE;
+        if (keep) scanner->open_fds++;
+    }
+
+    ssize_t n = pread(*fd, scanner->buffer, sizeof(scanner->buffer) - 1, 0);
+
+    if (!keep || n <= 0) {
+        close(*fd);
+        *fd = -1;
+        if (keep) scanner->open_fds--;
+    }
+    if (n <= 0) return FALSE;
+
+    scanner->buffer[n] = '\0';
+    return TRUE;
+}
+
+// Valor de la clave que hay en el buffer: ns de CPU o páginas residentes
+static guint64 parse_key_value(ProcessScanner *scanner, ProcessSortKey key) {
+    guint64 value = 0;
+
+    if (key == PROCESS_SORT_MEMORY) {
+        // statm: "size resident shared ..."
+        guint64 size;
+        const gchar *p = proc_parse_u64(scanner->buffer, &size);
+        proc_parse_u64(p, &value);
+    } else if (scanner->has_schedstat) {
+        // schedstat: "ns_en_cpu ns_esperando timeslices"
+        proc_parse_u64(scanner->buffer, &value);
+    } else {
+        guint64 ticks, rss;
+        const gchar *fields = parse_stat_comm(scanner->buffer, NULL, 0);
+        if (fields) {
+            parse_stat_fields(fields, &ticks, &rss);
+            value = ticks * (G_USEC_PER_SEC * 1000 / scanner->clock_ticks);
+        }
+    }
+
+    return value;
+}
+
+// Leer la clave de un proceso; FALSE si ya no existe. Un descriptor
+// persistente deja de leerse cuando el proceso muere aunque su PID se
+// reutilice, así que un fallo con el PID aún en /proc es un proceso nuevo
+static gboolean read_key(ProcessScanner *scanner, ProcessSortKey key, const gchar *pid_name,
+                         ProcessState *state, gboolean *restarted) {
+    const gchar *file = key_file(scanner, key);
+
+    *restarted = FALSE;
+    if (state->fd >= 0) {
+        // Si falla, read_process_file ya ha cerrado el descriptor
+        if (read_process_file(scanner, pid_name, file, &state->fd, TRUE)) return TRUE;
+
+        *restarted = TRUE;
+    }
+
+    gboolean keep = scanner->open_fds < scanner->fd_budget;
+    return read_process_file(scanner, pid_name, file, &state->fd, keep);
+}
+
+static double sort_value(const ProcessState *state, ProcessSortKey key) {
+    return key == PROCESS_SORT_CPU ? state->info.cpu_percent : (double)state->info.rss_kb;
+}
+
+// Inserción en el top-N ya ordenado: O(n) por proceso con n pequeño
+static void top_insert(ProcessState **top, guint *count, guint n, ProcessState *state, ProcessSortKey key) {
+    double value = sort_value(state, key);
+    guint pos = *count;
+
+    if (pos == n && value <= sort_value(top[n - 1], key)) return;
+
+    while (pos > 0 && sort_value(top[pos - 1], key) < value) {
+        if (pos < n) top[pos] = top[pos - 1];
+        pos--;
+    }
+    if (pos < n) top[pos] = state;
+    if (*count < n) (*count)++;
+}
+
+static gboolean process_is_gone(gpointer key G_GNUC_UNUSED, gpointer value, gpointer user_data) {
+    ProcessScanner *scanner = user_data;
+    ProcessState *state = value;
+
+    if (state->generation == scanner->generation) return FALSE;
+
+    process_state_close(scanner, state);
+    return TRUE;
+}
+
+// Nombre y memoria de los procesos que se muestran: un stat completo, solo para N
+static void fill_details(ProcessScanner *scanner, ProcessState *state) {
+    gchar pid_name[16];
+    int fd = -1;
+
+    g_snprintf(pid_name, sizeof(pid_name), "%d", state->info.pid);
+    if (!read_process_file(scanner, pid_name, "stat", &fd, FALSE)) return;
+
+    const gchar *fields = parse_stat_comm(scanner->buffer, state->info.name, sizeof(state->info.name));
+    if (!fields) return;
+
+    guint64 ticks, rss_pages;
+    parse_stat_fields(fields, &ticks, &rss_pages);
+    state->info.rss_kb = rss_pages * scanner->page_kb;
+}
+
+guint process_scanner_scan(ProcessScanner *scanner, ProcessSortKey key, ProcessInfo *top, guint n) {
+    g_return_val_if_fail(scanner != NULL, 0);
+
+    ProcessState *best[PROCESS_SCANNER_MAX_TOP];
+    gint64 now = g_get_monotonic_time();
+    guint count = 0;
+    guint seen = 0;
+    struct dirent *entry;
+
+    n = MIN(n, PROCESS_SCANNER_MAX_TOP);
+
+    // Otra clave es otro archivo: los valores anteriores no sirven
+    if (key != scanner->key) {
+        close_all(scanner);
+        g_hash_table_remove_all(scanner->processes);
+        scanner->key = key;
+        scanner->prev_time = 0;
+    }
+
+    double elapsed_ns = scanner->prev_time > 0 ? (now - scanner->prev_time) * 1000.0 : 0.0;
+
+    scanner->generation++;
+    rewinddir(scanner->dir);
+
+    while ((entry = readdir(scanner->dir))) {
+        if (!g_ascii_isdigit(entry->d_name[0])) continue;
+
+        gint pid = atoi(entry->d_name);
+        ProcessState *state = g_hash_table_lookup(scanner->processes, GINT_TO_POINTER(pid));
+        gboolean is_new = state == NULL;
+        gboolean restarted;
+
+        if (is_new) {
+            state = g_new0(ProcessState, 1);
+            state->info.pid = pid;
+            state->fd = -1;
+        }
+
+        if (!read_key(scanner, key, entry->d_name, state, &restarted)) {
+            if (is_new) {
+                g_free(state);
+            }
+            continue;
+        }
+
+        guint64 value = parse_key_value(scanner, key);
+
+        if (key == PROCESS_SORT_MEMORY) {
+            state->info.rss_kb = value * scanner->page_kb;
+        } else if (!is_new && !restarted && elapsed_ns > 0 && value >= state->value) {
+            state->info.cpu_percent = (value - state->value) * 100.0 / elapsed_ns;
+        } else {
+            state->info.cpu_percent = 0.0;
+        }
+        state->value = value;
+        state->generation = scanner->generation;
+
+        if (is_new) {
+            g_hash_table_insert(scanner->processes, GINT_TO_POINTER(pid), state);
+        }
+        seen++;
+
+        if (n > 0) {
+            top_insert(best, &count, n, state, key);
+        }
+    }
+
+    if (seen != g_hash_table_size(scanner->processes)) {
+        g_hash_table_foreach_remove(scanner->processes, process_is_gone, scanner);
+    }
+
+    for (guint i = 0; i < count; i++) {
+        fill_details(scanner, best[i]);
+        top[i] = best[i]->info;
+    }
+
+    scanner->prev_time = now;
+    return count;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Procesos con más CPU o memoria a partir de /proc/[pid]. El estado de cada
+// PID se conserva entre recorridos: el uso de CPU se calcula por diferencia y
+// el archivo con el dato de la clave de orden queda abierto (openat() relativo
+// a un descriptor de /proc) para que cada recorrido sea un pread() por proceso.
+// No es seguro usar el mismo scanner desde dos hilos a la vez.
+typedef struct _ProcessScanner ProcessScanner;
+
+#define PROCESS_SCANNER_MAX_TOP 32
+
+typedef enum {
+    PROCESS_SORT_CPU,
+    PROCESS_SORT_MEMORY,
+} ProcessSortKey;
+
+typedef struct {
+    gint pid;
+    gchar name[16];         // comm, como mucho 15 caracteres (TASK_COMM_LEN)
+    double cpu_percent;     // 100 = un núcleo completo, como top; solo con PROCESS_SORT_CPU
+    guint64 rss_kb;
+} ProcessInfo;
+
+// NULL si no se puede abrir /proc
+ProcessScanner *process_scanner_new(void);
+void process_scanner_free(ProcessScanner *scanner);
+
+// Recorrer /proc y dejar en `top` los `n` procesos (como mucho
+// PROCESS_SCANNER_MAX_TOP) con más `key`, de mayor a menor; devuelve cuántos se
+// han escrito. Con PROCESS_SORT_CPU el primer recorrido, o el primero tras
+// cambiar de clave, no tiene con qué comparar y da 0 % para todos.
+guint process_scanner_scan(ProcessScanner *scanner, ProcessSortKey key, ProcessInfo *top, guint n);
+
+G_END_DECLS
@@ -0,0 +1,45 @@
+#include "snapshot_slot.h"
+
+void snapshot_slot_init(SnapshotSlot *slot, GDestroyNotify free_func) {
+    slot->pending = NULL;
+    slot->pending_sources = 0;
+    slot->free_func = free_func;
+}
+
+// Sustituir atómicamente la muestra pendiente y devolver la anterior
+static gpointer exchange_pending(SnapshotSlot *slot, gpointer snapshot) {
+    gpointer old;
+
+    do {
+        old = g_atomic_pointer_get(&slot->pending);
+    } while (!g_atomic_pointer_compare_and_exchange(&slot->pending, old, snapshot));
+
+    return old;
+}
+
+void snapshot_slot_clear(SnapshotSlot *slot) {
+    gpointer snapshot = exchange_pending(slot, NULL);
+
+    if (snapshot) {
+        slot->free_func(snapshot);
+    }
+    slot->pending_sources = 0;
+}
+
+void snapshot_slot_publish(SnapshotSlot *slot, gpointer snapshot, guint sources) {
+    gpointer old = exchange_pending(slot, snapshot);
+
+    // La que no se llegó a recoger ya no le interesa a nadie
+    if (old) {
+        slot->free_func(old);
+    }
+
+    // Primero la muestra y después la máscara: el consumidor recoge en orden
+    // inverso, así nunca ve una máscara con datos más antiguos que ella
+    g_atomic_int_or(&slot->pending_sources, sources);
+}
+
+gpointer snapshot_slot_take(SnapshotSlot *slot, guint *sources) {
+    *sources = g_atomic_int_and(&slot->pending_sources, 0);
+    return exchange_pending(slot, NULL);
+}
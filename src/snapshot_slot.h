@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Relevo de muestras de un hilo productor al hilo principal, solo con
+// operaciones atómicas. El productor deja una muestra y la máscara de fuentes
+// que trae; si la anterior no se llegó a recoger se libera y su máscara se
+// acumula. El consumidor recoge la última muestra y todas las fuentes
+// publicadas desde la recogida anterior.
+typedef struct {
+    gpointer pending;           // última muestra sin recoger
+    guint pending_sources;      // fuentes publicadas desde la última recogida
+    GDestroyNotify free_func;
+} SnapshotSlot;
+
+void snapshot_slot_init(SnapshotSlot *slot, GDestroyNotify free_func);
+
+// Liberar la muestra pendiente; ningún hilo puede seguir usando el relevo
+void snapshot_slot_clear(SnapshotSlot *slot);
+
+// Hilo productor: el relevo pasa a ser dueño de `snapshot`
+void snapshot_slot_publish(SnapshotSlot *slot, gpointer snapshot, guint sources);
+
+// Hilo consumidor: la muestra más reciente (NULL si no hay ninguna nueva) y,
+// en `sources`, las fuentes publicadas desde la última recogida. Con una
+// máscara no vacía y NULL, la muestra que las cubre ya se recogió antes
+gpointer snapshot_slot_take(SnapshotSlot *slot, guint *sources);
+
+G_END_DECLS
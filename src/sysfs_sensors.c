@@ -0,0 +1,305 @@
+#include "sysfs_sensors.h"
+#include "proc_reader.h"
+#include <stdlib.h>
+
+// Tope de descriptores abiertos: hay máquinas con cientos de entradas hwmon
+// y cientos de CPUs; más allá de esto la media de frecuencia es de una muestra
+#define MAX_SENSORS 64
+#define MAX_CPUFREQ_POLICIES 64
+
+// Los valores que se leen son de unos pocos bytes ("45000", "Discharging");
+// si alguno no cabe, el buffer crece en la primera lectura
+#define SYSFS_VALUE_SIZE 32
+
+typedef struct {
+    SystemMonitorSensorKind kind;
+    gchar *label;
+    ProcFile *value;        // temp*_input, temp, capacity
+    ProcFile *status;       // baterías: "Charging", "Discharging", "Full"...
+    double scale;           // de las unidades de sysfs a las de SystemMonitorSensor
+} Sensor;
+
+struct _SysfsSensors {
+    GArray *sensors;                // Sensor, ordenados por tipo y etiqueta
+    SystemMonitorSensor *values;    // en paralelo a sensors; lo que se publica
+    GPtrArray *cpufreq;             // ProcFile de scaling_cur_freq por política
+};
+
+// Atributo de una línea (name, type, temp1_label...) sin el salto final; NULL si no existe
+static gchar *read_attribute(const gchar *dir, const gchar *name) {
+    gchar *path = g_build_filename(dir, name, NULL);
+    gchar *contents = NULL;
+
+    if (g_file_get_contents(path, &contents, NULL, NULL)) {
+        g_strstrip(contents);
+    }
+
+    g_free(path);
+    return contents;
+}
+
+static gboolean add_sensor(SysfsSensors *sensors, SystemMonitorSensorKind kind, gchar *label,
+                           const gchar *value_path, const gchar *status_path, double scale) {
+    if (sensors->sensors->len >= MAX_SENSORS) {
+        g_free(label);
+        return FALSE;
+    }
+
+    ProcFile *value = proc_file_open_sized(value_path, SYSFS_VALUE_SIZE);
+    if (!value) {
+        g_free(label);
+        return FALSE;
+    }
+
+    Sensor sensor = {
+        .kind = kind,
+        .label = label,
+        .value = value,
+        .status = status_path ? proc_file_open_sized(status_path, SYSFS_VALUE_SIZE) : NULL,
+        .scale = scale,
+    };
+    g_array_append_val(sensors->sensors, sensor);
+    return TRUE;
+}
+
+// hwmon: tempN_input en milésimas de grado, con tempN_label opcional
+static void discover_hwmon(SysfsSensors *sensors) {
+    GDir *dir = g_dir_open("/sys/class/hwmon", 0, NULL);
+    const gchar *entry;
+
+    if (!dir) return;
+
+    while ((entry = g_dir_read_name(dir))) {
+        gchar *chip_path = g_build_filename("/sys/class/hwmon", entry, NULL);
+        gchar *chip = read_attribute(chip_path, "name");
+        GDir *chip_dir = g_dir_open(chip_path, 0, NULL);
+        const gchar *file;
+
+        while (chip_dir && (file = g_dir_read_name(chip_dir))) {
+            if (!g_str_has_prefix(file, "temp") || !g_str_has_suffix(file, "_input")) continue;
+
+            gchar *prefix = g_strndup(file, strlen(file) - strlen("_input"));
+            gchar *label_name = g_strconcat(prefix, "_label", NULL);
+            gchar *label = read_attribute(chip_path, label_name);
+            gchar *path = g_build_filename(chip_path, file, NULL);
+
+            add_sensor(sensors, SYSTEM_MONITOR_SENSOR_TEMPERATURE,
+                       g_strdup_printf("%s: %s", chip ? chip : entry, label ? label : prefix),
+                       path, NULL, 0.001);
+
+            g_free(path);
+            g_free(label);
+            g_free(label_name);
+            g_free(prefix);
+        }
+
+        if (chip_dir) g_dir_close(chip_dir);
+        g_free(chip);
+        g_free(chip_path);
+    }
+
+    g_dir_close(dir);
+}
+
+// Zonas térmicas: el kernel ya las expone también por hwmon salvo las
+// marcadas no_hwmon, así que solo se usan si hwmon no tiene temperaturas
+static void discover_thermal_zones(SysfsSensors *sensors) {
+    GDir *dir = g_dir_open("/sys/class/thermal", 0, NULL);
+    const gchar *entry;
+
+    if (!dir) return;
+
+    while ((entry = g_dir_read_name(dir))) {
+        if (!g_str_has_prefix(entry, "thermal_zone")) continue;
+
+        gchar *zone_path = g_build_filename("/sys/class/thermal", entry, NULL);
+        gchar *type = read_attribute(zone_path, "type");
+        gchar *path = g_build_filename(zone_path, "temp", NULL);
+
+        add_sensor(sensors, SYSTEM_MONITOR_SENSOR_TEMPERATURE,
+                   g_strdup(type ? type : entry), path, NULL, 0.001);
+
+        g_free(path);
+        g_free(type);
+        g_free(zone_path);
+    }
+
+    g_dir_close(dir);
+}
+
+// Baterías del sistema; las de periféricos (scope=Device: ratones, mandos...) no
+static void discover_batteries(SysfsSensors *sensors) {
+    GDir *dir = g_dir_open("/sys/class/power_supply", 0, NULL);
+    const gchar *entry;
+
+    if (!dir) return;
+
+    while ((entry = g_dir_read_name(dir))) {
+        gchar *supply_path = g_build_filename("/sys/class/power_supply", entry, NULL);
+        gchar *type = read_attribute(supply_path, "type");
+        gchar *scope = read_attribute(supply_path, "scope");
+
+        if (g_strcmp0(type, "Battery") == 0 && g_strcmp0(scope, "Device") != 0) {
+            gchar *capacity = g_build_filename(supply_path, "capacity", NULL);
+            gchar *status = g_build_filename(supply_path, "status", NULL);
+
+            add_sensor(sensors, SYSTEM_MONITOR_SENSOR_BATTERY, g_strdup(entry),
+                       capacity, status, 1.0);
+
+            g_free(status);
+            g_free(capacity);
+        }
+
+        g_free(scope);
+        g_free(type);
+        g_free(supply_path);
+    }
+
+    g_dir_close(dir);
+}
+
+// Una política agrupa las CPUs que comparten reloj: basta con leer una por grupo
+static void discover_cpufreq(SysfsSensors *sensors) {
+    GDir *dir = g_dir_open("/sys/devices/system/cpu/cpufreq", 0, NULL);
+    const gchar *entry;
+
+    if (!dir) return;
+
+    while ((entry = g_dir_read_name(dir)) && sensors->cpufreq->len < MAX_CPUFREQ_POLICIES) {
+        if (!g_str_has_prefix(entry, "policy")) continue;
+
+        gchar *path = g_build_filename("/sys/devices/system/cpu/cpufreq", entry,
+                                       "scaling_cur_freq", NULL);
+        ProcFile *file = proc_file_open_sized(path, SYSFS_VALUE_SIZE);
+        if (file) {
+            g_ptr_array_add(sensors->cpufreq, file);
+        }
+        g_free(path);
+    }
+
+    g_dir_close(dir);
+}
+
+static int compare_sensors(const void *a, const void *b) {
+    const Sensor *sa = a;
+    const Sensor *sb = b;
+
+    if (sa->kind != sb->kind) return sa->kind < sb->kind ? -1 : 1;
+    return g_utf8_collate(sa->label, sb->label);
+}
+
+SysfsSensors *sysfs_sensors_new(void) {
+    SysfsSensors *sensors = g_malloc0(sizeof(SysfsSensors));
+    sensors->sensors = g_array_new(FALSE, FALSE, sizeof(Sensor));
+    sensors->cpufreq = g_ptr_array_new_with_free_func((GDestroyNotify)proc_file_close);
+
+    discover_hwmon(sensors);
+    if (sensors->sensors->len == 0) {
+        discover_thermal_zones(sensors);
+    }
+    discover_batteries(sensors);
+    discover_cpufreq(sensors);
+
+    // El orden de /sys no es estable entre arranques; el del tooltip sí debe serlo
+    g_array_sort(sensors->sensors, compare_sensors);
+
+    sensors->values = g_new0(SystemMonitorSensor, MAX(sensors->sensors->len, 1));
+    for (guint i = 0; i < sensors->sensors->len; i++) {
+        Sensor *sensor = &g_array_index(sensors->sensors, Sensor, i);
+        sensors->values[i].kind = sensor->kind;
+        sensors->values[i].label = sensor->label;
+    }
+
+    g_debug("Sensores: %u en hwmon/thermal/power_supply, %u políticas de cpufreq",
+            sensors->sensors->len, sensors->cpufreq->len);
+
+    return sensors;
+}
+
+void sysfs_sensors_free(SysfsSensors *sensors) {
+    if (!sensors) return;
+
+    for (guint i = 0; i < sensors->sensors->len; i++) {
+        Sensor *sensor = &g_array_index(sensors->sensors, Sensor, i);
+        g_free(sensor->label);
+        proc_file_close(sensor->value);
+        proc_file_close(sensor->status);
+    }
+
+    g_array_free(sensors->sensors, TRUE);
+    g_ptr_array_free(sensors->cpufreq, TRUE);
+    g_free(sensors->values);
+    g_free(sensors);
+}
+
+// Los valores de sysfs son enteros, y las temperaturas pueden ser negativas.
+// Un sensor apagado o desconectado falla con EIO/ENODATA en lugar de dar 0
+static gboolean read_integer(ProcFile *file, gint64 *value) {
+    const gchar *data = proc_file_read(file, NULL);
+    gchar *end;
+
+    if (!data) return FALSE;
+
+    *value = g_ascii_strtoll(data, &end, 10);
+    return end != data;
+}
+
+void sysfs_sensors_read(SysfsSensors *sensors, SystemMonitorSensors *out) {
+    double battery_sum = 0.0;
+    guint batteries = 0;
+
+    memset(out, 0, sizeof(*out));
+
+    for (guint i = 0; i < sensors->sensors->len; i++) {
+        Sensor *sensor = &g_array_index(sensors->sensors, Sensor, i);
+        SystemMonitorSensor *info = &sensors->values[i];
+        gint64 raw;
+
+        info->valid = read_integer(sensor->value, &raw);
+        if (!info->valid) continue;
+
+        info->value = raw * sensor->scale;
+
+        switch (sensor->kind) {
+        case SYSTEM_MONITOR_SENSOR_TEMPERATURE:
+            if (!out->has_temperature || info->value > out->temperature) {
+                out->temperature = info->value;
+            }
+            out->has_temperature = TRUE;
+            break;
+        case SYSTEM_MONITOR_SENSOR_BATTERY:
+            if (sensor->status) {
+                const gchar *status = proc_file_read(sensor->status, NULL);
+                info->charging = status && g_str_has_prefix(status, "Charging");
+            }
+            battery_sum += info->value;
+            batteries++;
+            out->charging |= info->charging;
+            break;
+        }
+    }
+
+    if (batteries > 0) {
+        out->has_battery = TRUE;
+        out->battery = battery_sum / batteries;
+    }
+
+    double frequency_sum = 0.0;
+    guint policies = 0;
+
+    for (guint i = 0; i < sensors->cpufreq->len; i++) {
+        gint64 khz;
+        if (read_integer(g_ptr_array_index(sensors->cpufreq, i), &khz)) {
+            frequency_sum += khz / 1000.0;
+            policies++;
+        }
+    }
+
+    if (policies > 0) {
+        out->has_frequency = TRUE;
+        out->frequency = frequency_sum / policies;
+    }
+
+    out->n_sensors = sensors->sensors->len;
+    out->sensors = sensors->values;
+}
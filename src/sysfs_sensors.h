@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glib.h>
+#include "system_monitor.h"
+
+G_BEGIN_DECLS
+
+// Sensores de hwmon, thermal, cpufreq y power_supply. Los archivos se buscan
+// una sola vez al crear el lector y se dejan abiertos (ProcFile): cada lectura
+// es un pread() por sensor, sin recorrer /sys de nuevo.
+typedef struct _SysfsSensors SysfsSensors;
+
+SysfsSensors *sysfs_sensors_new(void);
+void sysfs_sensors_free(SysfsSensors *sensors);
+
+// Releer todos los sensores y rellenar `out`; out->sensors apunta a memoria
+// del lector, válida hasta la siguiente lectura
+void sysfs_sensors_read(SysfsSensors *sensors, SystemMonitorSensors *out);
+
+G_END_DECLS
@@ -0,0 +1,1450 @@
+#include "system_monitor.h"
+#include "proc_reader.h"
+#include "timebase.h"
+#include "netlink_stats.h"
+#include "event_source.h"
+#include "sysfs_sensors.h"
+#include "snapshot_slot.h"
+#include <math.h>
+
+#define SOURCE_COUNT 7
+
+// Muestreo adaptativo: tras STABLE_SAMPLES lecturas estables el intervalo se
+// duplica hasta base << MAX_BACKOFF_LEVEL; sin nadie mirando se usa
+// HIDDEN_BACKOFF_LEVEL directamente. Nunca se pasa de MAX_INTERVAL_MS
+#define STABLE_SAMPLES 3
+#define MAX_BACKOFF_LEVEL 3
+#define HIDDEN_BACKOFF_LEVEL 5
+#define MAX_INTERVAL_MS 60000
+
+// Umbrales por debajo de los cuales una lectura se considera igual a la anterior
+#define STABLE_PERCENT 2.0
+#define STABLE_NET_KBPS 1.0
+#define STABLE_NET_RATIO 0.1
+
+// Trigger de PSI: avisar si hay 150 ms de espera por memoria en una ventana
+// de 2 s (las ventanas múltiplo de 2 s las admite el kernel sin privilegios)
+#define PSI_MEMORY_TRIGGER "some 150000 2000000"
+
+// Holgado respecto a IFNAMSIZ (16)
+#define IFACE_NAME_MAX 32
+
+// Los nombres de /proc/diskstats (nvme0n1p12, mmcblk0boot1...) son cortos
+#define DEVICE_NAME_MAX 32
+
+// /proc/diskstats cuenta en sectores de 512 bytes sea cual sea el dispositivo
+#define DISK_SECTOR_SIZE 512
+
+// Contadores por núcleo en formato struct-of-arrays para que el cálculo de
+// deltas sea un único bucle vectorizable
+typedef struct {
+    guint count;
+    guint capacity;
+    guint64 *total;
+    guint64 *idle;
+    guint64 *prev_total;
+    guint64 *prev_idle;
+    float *usage;
+} CpuCores;
+
+// Estado persistente de cada interfaz de red entre lecturas
+typedef struct {
+    SystemMonitorInterface info;
+    gchar name[IFACE_NAME_MAX];
+    guint64 generation;     // última lectura en la que apareció
+} NetInterface;
+
+// Estado persistente de cada dispositivo de bloque: contadores de la lectura anterior
+typedef struct {
+    SystemMonitorDevice info;
+    gchar name[DEVICE_NAME_MAX];
+    gchar parent[DEVICE_NAME_MAX];  // disco de una partición, "" si no lo es
+    guint64 generation;
+    guint64 counted;        // lectura de la que son los contadores guardados
+    guint64 reads;
+    guint64 writes;
+    guint64 read_sectors;
+    guint64 write_sectors;
+    guint64 io_ticks;       // ms con E/S en curso
+} DiskDevice;
+
+typedef struct {
+    guint subscribers;
+    guint visible;          // suscriptores que están en pantalla
+    guint interval_ms;      // intervalo base pedido por los widgets
+    guint level;            // intervalo efectivo: interval_ms << level
+    guint stable_samples;
+    double reference;       // valor de la última lectura que contó como cambio
+    gint64 next_due;        // tiempo monotónico (µs) de la siguiente lectura
+    gint64 last_sample;
+    guint periods;          // intervalos base que cubre la última emisión de "updated"
+    guint64 unreported;     // intervalos de muestras ya recogidas que aún no se emitieron
+} SourceState;
+
+// Muestra publicada por el hilo de muestreo. Es inmutable: el hilo principal
+// la usa tal cual hasta recoger la siguiente
+typedef struct {
+    SystemMonitorSnapshot data;
+    float *core_usage;          // data.cpu.core_usage apunta aquí
+    GHashTable *interfaces;     // nombre → NetInterface; compartida si la red no cambió
+    GHashTable *disks;          // nombre → DiskDevice; ídem con los discos
+    SystemMonitorSensor *sensors; // data.sensors.sensors apunta aquí
+    guint64 periods[SOURCE_COUNT];  // intervalos base leídos desde el arranque, por fuente
+} PublishedSnapshot;
+
+struct _SystemMonitor {
+    GObject parent_instance;
+
+    // --- Hilo principal ---
+
+    SourceState sources[SOURCE_COUNT];
+
+    // Un único temporizador para todas las fuentes
+    guint timeout_id;
+    guint tick_ms;
+
+    // Trigger de PSI: el kernel avisa (POLLPRI) al superar el umbral
+    GSource *psi_source;
+
+    PublishedSnapshot *current;
+
+    // --- Relevo entre hilos, solo con operaciones atómicas ---
+
+    guint requested_sources;    // fuentes pedidas y aún no leídas
+    guint requested_periods[SOURCE_COUNT]; // intervalos base que cubren esas peticiones
+    SnapshotSlot published;     // última PublishedSnapshot sin recoger
+    GSource *request_source;    // despierta al hilo de muestreo
+    GSource *publish_source;    // despierta al hilo principal
+
+    // --- Hilo de muestreo: el hilo principal no toca nada de aquí ---
+
+    GThread *worker;
+    GMainContext *worker_context;
+    GMainLoop *worker_loop;
+
+    // Intervalos pedidos pendientes de publicar y totales ya publicados
+    guint sampling_periods[SOURCE_COUNT];
+    guint64 total_periods[SOURCE_COUNT];
+
+    // Descriptores persistentes de /proc
+    ProcFile *stat_file;
+    ProcFile *meminfo_file;
+    ProcFile *netdev_file;
+    ProcFile *psi_memory_file;
+    ProcFile *psi_cpu_file;
+    ProcFile *diskstats_file;
+
+    // Datos anteriores para calcular deltas
+    guint64 prev_cpu_total;
+    guint64 prev_cpu_idle;
+    CpuCores cores;
+    gint64 prev_net_time;
+
+    // Lectura de red en curso (compartida por /proc/net/dev y netlink)
+    gint64 net_sample_time;
+    guint net_seen;
+    guint64 net_rx_delta;
+    guint64 net_tx_delta;
+    guint64 net_total_rx;
+    guint64 net_total_tx;
+
+    // Backend netlink; NULL si se usa /proc/net/dev
+    NetlinkStats *netlink;
+
+    // Interfaces de red por nombre y filtros glob de [net_monitor]
+    GHashTable *interfaces;
+    guint64 net_generation;
+    gchar **net_include;
+    gchar **net_exclude;
+    GHashTable *published_interfaces;
+
+    // Dispositivos de bloque por nombre y filtros de [disk_monitor]
+    GHashTable *disks;
+    guint64 disk_generation;
+    gint64 prev_disk_time;
+    gchar **disk_include;
+    gchar **disk_exclude;
+    gboolean disk_partitions;
+    GHashTable *published_disks;
+
+    // Sensores de /sys; se descubren en la primera lectura
+    SysfsSensors *sysfs_sensors;
+
+    // Gancho de las pruebas antes de cada lectura
+    SystemMonitorReadHook read_hook;
+    gpointer read_hook_data;
+
+    // Lecturas acumuladas; se copian en cada PublishedSnapshot
+    SystemMonitorSnapshot snapshot;
+};
+
+enum {
+    SIGNAL_UPDATED,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+G_DEFINE_TYPE(SystemMonitor, system_monitor, G_TYPE_OBJECT)
+
+static guint source_index(SystemMonitorSource source) {
+    return (guint)g_bit_nth_lsf(source, -1);
+}
+
+// Abrir el archivo la primera vez que se necesita
+static const gchar *read_proc_file(ProcFile **file, const gchar *path) {
+    if (!*file) {
+        *file = proc_file_open(path);
+        if (!*file) return NULL;
+    }
+    return proc_file_read(*file, NULL);
+}
+
+static void cpu_cores_reserve(CpuCores *cores, guint count) {
+    if (count <= cores->capacity) return;
+
+    cores->capacity = MAX(count, cores->capacity * 2);
+    cores->total = g_renew(guint64, cores->total, cores->capacity);
+    cores->idle = g_renew(guint64, cores->idle, cores->capacity);
+    cores->prev_total = g_renew(guint64, cores->prev_total, cores->capacity);
+    cores->prev_idle = g_renew(guint64, cores->prev_idle, cores->capacity);
+    cores->usage = g_renew(float, cores->usage, cores->capacity);
+}
+
+// Sin saltos ni dependencias entre iteraciones para que GCC lo vectorice
+// (-O3): los deltas por tick caben en 32 bits, se acotan con min/max enteros
+// y solo la división final se hace en float
+static void cpu_cores_compute_usage(const guint64 *restrict total, const guint64 *restrict idle,
+                                    const guint64 *restrict prev_total, const guint64 *restrict prev_idle,
+                                    float *restrict usage, guint count) {
+    for (guint i = 0; i < count; i++) {
+        gint32 total_diff = (gint32)(total[i] - prev_total[i]);
+        gint32 idle_diff = (gint32)(idle[i] - prev_idle[i]);
+        gint32 busy = MAX(total_diff - idle_diff, 0);
+        gint32 span = MAX(MAX(total_diff, busy), 1);
+
+        usage[i] = (float)busy * 100.0f / (float)span;
+    }
+}
+
+static void read_cpu_cores(SystemMonitor *self, const gchar *line) {
+    CpuCores *cores = &self->cores;
+    guint count = 0;
+
+    // Las líneas cpuN van justo después de la agregada
+    for (; line && strncmp(line, "cpu", 3) == 0 && g_ascii_isdigit(line[3]); line = proc_next_line(line)) {
+        cpu_cores_reserve(cores, count + 1);
+
+        const gchar *p = line + 3;
+        while (g_ascii_isdigit(*p)) p++;
+        proc_parse_cpu_line(p, &cores->total[count], &cores->idle[count]);
+        count++;
+    }
+
+    if (count == cores->count) {
+        cpu_cores_compute_usage(cores->total, cores->idle, cores->prev_total, cores->prev_idle,
+                                cores->usage, count);
+    } else {
+        // Primera muestra o cambio de núcleos (hotplug): empezar de cero
+        memset(cores->usage, 0, count * sizeof(float));
+        cores->count = count;
+    }
+
+    memcpy(cores->prev_total, cores->total, count * sizeof(guint64));
+    memcpy(cores->prev_idle, cores->idle, count * sizeof(guint64));
+
+    self->snapshot.cpu.n_cores = count;
+    self->snapshot.cpu.core_usage = cores->usage;
+}
+
+static void read_cpu_info(SystemMonitor *self, gboolean per_core) {
+    const gchar *data = read_proc_file(&self->stat_file, "/proc/stat");
+    if (!data || strncmp(data, "cpu ", 4) != 0) return;
+
+    guint64 total, idle_total;
+    proc_parse_cpu_line(data + 4, &total, &idle_total);
+
+    if (self->prev_cpu_total > 0 && total > self->prev_cpu_total) {
+        guint64 total_diff = total - self->prev_cpu_total;
+        guint64 idle_diff = idle_total - self->prev_cpu_idle;
+        double percent = ((double)(total_diff - idle_diff) / total_diff) * 100.0;
+
+        self->snapshot.cpu.usage_percent = CLAMP(percent, 0.0, 100.0);
+    }
+
+    self->prev_cpu_total = total;
+    self->prev_cpu_idle = idle_total;
+
+    if (per_core) {
+        read_cpu_cores(self, proc_next_line(data));
+    }
+}
+
+static void read_memory_info(SystemMonitor *self) {
+    const gchar *data = read_proc_file(&self->meminfo_file, "/proc/meminfo");
+    if (!data) return;
+
+    ProcMeminfo info;
+    proc_parse_meminfo(data, &info);
+
+    if (info.mem_total > 0) {
+        // Usar MemAvailable si está disponible, sino calcular
+        guint64 mem_used = info.mem_available > 0 ?
+            info.mem_total - info.mem_available :
+            info.mem_total - info.mem_free - info.buffers - info.cached;
+
+        self->snapshot.memory.total_kb = info.mem_total;
+        self->snapshot.memory.used_kb = mem_used;
+        self->snapshot.memory.used_percent = (mem_used * 100.0) / info.mem_total;
+    }
+
+    self->snapshot.memory.swap_total_kb = info.swap_total;
+    self->snapshot.memory.swap_used_kb = info.swap_total >= info.swap_free ? info.swap_total - info.swap_free : 0;
+    self->snapshot.memory.zswap_kb = info.zswap;
+    self->snapshot.memory.zswapped_kb = info.zswapped;
+}
+
+// "some avg10=1.23 avg60=... total=..." y la línea "full" equivalente
+static gboolean read_pressure_file(ProcFile **file, const gchar *path, SystemMonitorPsi *psi) {
+    const gchar *data = read_proc_file(file, path);
+    if (!data) return FALSE;
+
+    psi->some_avg10 = 0.0;
+    psi->full_avg10 = 0.0;
+
+    for (const gchar *line = data; line; line = proc_next_line(line)) {
+        double *target = NULL;
+
+        if (strncmp(line, "some ", 5) == 0) target = &psi->some_avg10;
+        else if (strncmp(line, "full ", 5) == 0) target = &psi->full_avg10;
+
+        if (target && strncmp(line + 5, "avg10=", 6) == 0) {
+            proc_parse_decimal(line + 11, target);
+        }
+    }
+
+    return TRUE;
+}
+
+static void read_pressure_info(SystemMonitor *self) {
+    SystemMonitorPressure *pressure = &self->snapshot.pressure;
+
+    pressure->available =
+        read_pressure_file(&self->psi_memory_file, "/proc/pressure/memory", &pressure->memory);
+    if (pressure->available) {
+        read_pressure_file(&self->psi_cpu_file, "/proc/pressure/cpu", &pressure->cpu);
+    }
+}
+
+static gboolean pattern_list_matches(gchar **patterns, const gchar *name) {
+    for (gint i = 0; patterns && patterns[i]; i++) {
+        if (g_pattern_match_simple(patterns[i], name)) return TRUE;
+    }
+    return FALSE;
+}
+
+// Un include vacío acepta todo; exclude tiene prioridad
+static gboolean filter_accepts(gchar **include, gchar **exclude, const gchar *name) {
+    if (include && include[0] && !pattern_list_matches(include, name)) {
+        return FALSE;
+    }
+    return !pattern_list_matches(exclude, name);
+}
+
+static gboolean interface_is_included(SystemMonitor *self, const gchar *name) {
+    return filter_accepts(self->net_include, self->net_exclude, name);
+}
+
+// Buscar la interfaz y, si es nueva, crearla con sus contadores como base.
+// Los filtros se evalúan una sola vez, al aparecer la interfaz
+static NetInterface *lookup_interface(SystemMonitor *self, const gchar *name, gsize name_len,
+                                      guint64 rx_bytes, guint64 tx_bytes, gboolean *is_new) {
+    gchar key[IFACE_NAME_MAX];
+
+    memcpy(key, name, name_len);
+    key[name_len] = '\0';
+
+    NetInterface *iface = g_hash_table_lookup(self->interfaces, key);
+    *is_new = iface == NULL;
+
+    if (!iface) {
+        iface = g_new0(NetInterface, 1);
+        memcpy(iface->name, key, name_len + 1);
+        iface->info.name = iface->name;
+        iface->info.included = interface_is_included(self, iface->name);
+        iface->info.rx_bytes = rx_bytes;
+        iface->info.tx_bytes = tx_bytes;
+        g_hash_table_insert(self->interfaces, iface->name, iface);
+    }
+
+    return iface;
+}
+
+static gboolean interface_is_gone(gpointer key G_GNUC_UNUSED, gpointer value, gpointer user_data) {
+    return ((NetInterface *)value)->generation != *(guint64 *)user_data;
+}
+
+// Una lectura de red se hace en tres pasos para que /proc/net/dev y netlink
+// compartan la lógica por interfaz: begin, una llamada por interfaz y finish
+static void network_begin(SystemMonitor *self) {
+    self->net_sample_time = g_get_monotonic_time();
+    self->net_generation++;
+    self->net_seen = 0;
+    self->net_rx_delta = 0;
+    self->net_tx_delta = 0;
+    self->net_total_rx = 0;
+    self->net_total_tx = 0;
+}
+
+static void network_add_interface(SystemMonitor *self, const gchar *name, gsize name_len,
+                                  guint64 rx_bytes, guint64 tx_bytes) {
+    if (name_len == 0 || name_len >= IFACE_NAME_MAX) return;
+
+    double elapsed = self->prev_net_time > 0 ?
+        (self->net_sample_time - self->prev_net_time) / (double)G_USEC_PER_SEC : 0.0;
+
+    gboolean is_new;
+    NetInterface *iface = lookup_interface(self, name, name_len, rx_bytes, tx_bytes, &is_new);
+    SystemMonitorInterface *info = &iface->info;
+    iface->generation = self->net_generation;
+    self->net_seen++;
+
+    // Una interfaz recién aparecida no aporta tráfico hasta la siguiente lectura;
+    // si los contadores retroceden (reinicio del driver) se toma como base nueva
+    if (!is_new && elapsed > 0 && rx_bytes >= info->rx_bytes && tx_bytes >= info->tx_bytes) {
+        guint64 rx_diff = rx_bytes - info->rx_bytes;
+        guint64 tx_diff = tx_bytes - info->tx_bytes;
+
+        info->rx_speed = rx_diff / 1024.0 / elapsed;
+        info->tx_speed = tx_diff / 1024.0 / elapsed;
+
+        if (info->included) {
+            self->net_rx_delta += rx_diff;
+            self->net_tx_delta += tx_diff;
+        }
+    } else {
+        info->rx_speed = 0.0;
+        info->tx_speed = 0.0;
+    }
+
+    info->rx_bytes = rx_bytes;
+    info->tx_bytes = tx_bytes;
+
+    if (info->included) {
+        self->net_total_rx += rx_bytes;
+        self->net_total_tx += tx_bytes;
+    }
+}
+
+static void network_finish(SystemMonitor *self) {
+    // Solo recorrer la tabla si alguna interfaz ha desaparecido
+    if (self->net_seen != g_hash_table_size(self->interfaces)) {
+        g_hash_table_foreach_remove(self->interfaces, interface_is_gone, &self->net_generation);
+    }
+
+    // Velocidad (KB/s) con el tiempo real transcurrido entre muestras
+    SystemMonitorNetwork *net = &self->snapshot.network;
+    if (self->prev_net_time > 0 && self->net_sample_time > self->prev_net_time) {
+        double elapsed = (self->net_sample_time - self->prev_net_time) / (double)G_USEC_PER_SEC;
+        net->rx_speed = self->net_rx_delta / 1024.0 / elapsed;
+        net->tx_speed = self->net_tx_delta / 1024.0 / elapsed;
+    }
+
+    net->rx_bytes = self->net_total_rx;
+    net->tx_bytes = self->net_total_tx;
+    self->prev_net_time = self->net_sample_time;
+}
+
+// Misma firma para /proc/net/dev y netlink
+static void on_interface_counters(const gchar *name, gsize name_len,
+                                  guint64 rx_bytes, guint64 tx_bytes, gpointer user_data) {
+    network_add_interface(SYSTEM_MONITOR(user_data), name, name_len, rx_bytes, tx_bytes);
+}
+
+static void read_network_info(SystemMonitor *self) {
+    const gchar *data = read_proc_file(&self->netdev_file, "/proc/net/dev");
+    if (!data) return;
+
+    network_begin(self);
+    proc_parse_net_dev(data, on_interface_counters, self);
+    network_finish(self);
+}
+
+static void publish_snapshot(SystemMonitor *self, guint sources);
+
+static void on_netlink_done(gboolean success, gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+
+    // Si el volcado falló no se publica nada: la siguiente petición lo repetirá
+    if (!success) return;
+
+    network_finish(self);
+    publish_snapshot(self, SYSTEM_MONITOR_NETWORK);
+}
+
+// Con netlink la lectura termina más tarde, en on_netlink_done
+static gboolean request_network_info(SystemMonitor *self) {
+    if (!netlink_stats_request(self->netlink)) return FALSE;
+
+    network_begin(self);
+    return TRUE;
+}
+
+// En sysfs las particiones tienen un archivo "partition" y su enlace en
+// /sys/class/block apunta dentro del directorio del disco
+// (.../block/nvme0n1/nvme0n1p2). Los nombres con '/' de /proc/diskstats
+// (cciss/c0d0) aparecen ahí con '!'
+static gboolean device_is_partition(const gchar *name, gchar parent[DEVICE_NAME_MAX]) {
+    gchar *sys_name = g_strdelimit(g_strdup(name), "/", '!');
+    gchar *link = g_build_filename("/sys/class/block", sys_name, NULL);
+    gchar *path = g_build_filename(link, "partition", NULL);
+    gboolean partition = g_file_test(path, G_FILE_TEST_EXISTS);
+
+    parent[0] = '\0';
+    if (partition) {
+        gchar *target = g_file_read_link(link, NULL);
+        if (target) {
+            gchar *dir = g_path_get_dirname(target);
+            gchar *parent_name = g_path_get_basename(dir);
+
+            g_strlcpy(parent, g_strdelimit(parent_name, "!", '/'), DEVICE_NAME_MAX);
+
+            g_free(parent_name);
+            g_free(dir);
+            g_free(target);
+        }
+    }
+
+    g_free(path);
+    g_free(link);
+    g_free(sys_name);
+    return partition;
+}
+
+static gboolean device_is_included(SystemMonitor *self, const DiskDevice *device) {
+    if (device->info.partition && !self->disk_partitions) return FALSE;
+    return filter_accepts(self->disk_include, self->disk_exclude, device->name);
+}
+
+// Buscar el dispositivo y, si es nuevo, crearlo; el filtro y la comprobación
+// de partición en sysfs se hacen una sola vez, al aparecer
+static DiskDevice *lookup_disk(SystemMonitor *self, const gchar *name, gsize name_len) {
+    gchar key[DEVICE_NAME_MAX];
+
+    memcpy(key, name, name_len);
+    key[name_len] = '\0';
+
+    DiskDevice *device = g_hash_table_lookup(self->disks, key);
+
+    if (!device) {
+        device = g_new0(DiskDevice, 1);
+        memcpy(device->name, key, name_len + 1);
+        device->info.name = device->name;
+        device->info.partition = device_is_partition(device->name, device->parent);
+        device->info.included = device_is_included(self, device);
+        g_hash_table_insert(self->disks, device->name, device);
+    }
+
+    return device;
+}
+
+static gboolean disk_is_gone(gpointer key G_GNUC_UNUSED, gpointer value, gpointer user_data) {
+    return ((DiskDevice *)value)->generation != *(guint64 *)user_data;
+}
+
+// Tasas de un dispositivo a partir de sus contadores acumulados
+static void disk_update_rates(SystemMonitor *self, DiskDevice *device, const guint64 *fields, double elapsed) {
+    // major minor name | reads merged sectors ms | writes merged sectors ms | en curso io_ticks ...
+    guint64 reads = fields[0], read_sectors = fields[2];
+    guint64 writes = fields[4], write_sectors = fields[6];
+    guint64 io_ticks = fields[9];
+    SystemMonitorDevice *info = &device->info;
+
+    // Sin contadores de la lectura anterior (dispositivo nuevo o recién incluido
+    // por el filtro) o si retroceden, no aporta hasta la siguiente lectura
+    gboolean valid = device->counted + 1 == self->disk_generation;
+
+    if (valid && elapsed > 0 && reads >= device->reads && writes >= device->writes &&
+        read_sectors >= device->read_sectors && write_sectors >= device->write_sectors &&
+        io_ticks >= device->io_ticks) {
+        info->read_speed = (read_sectors - device->read_sectors) * (DISK_SECTOR_SIZE / 1024.0) / elapsed;
+        info->write_speed = (write_sectors - device->write_sectors) * (DISK_SECTOR_SIZE / 1024.0) / elapsed;
+        info->read_iops = (reads - device->reads) / elapsed;
+        info->write_iops = (writes - device->writes) / elapsed;
+        info->busy_percent = MIN((io_ticks - device->io_ticks) / (elapsed * 10.0), 100.0);
+    } else {
+        info->read_speed = 0.0;
+        info->write_speed = 0.0;
+        info->read_iops = 0.0;
+        info->write_iops = 0.0;
+        info->busy_percent = 0.0;
+    }
+
+    device->reads = reads;
+    device->writes = writes;
+    device->read_sectors = read_sectors;
+    device->write_sectors = write_sectors;
+    device->io_ticks = io_ticks;
+    device->counted = self->disk_generation;
+}
+
+static void read_disk_info(SystemMonitor *self) {
+    const gchar *data = read_proc_file(&self->diskstats_file, "/proc/diskstats");
+    if (!data) return;
+
+    gint64 now = g_get_monotonic_time();
+    double elapsed = self->prev_disk_time > 0 ? (now - self->prev_disk_time) / (double)G_USEC_PER_SEC : 0.0;
+    SystemMonitorDisk totals = { 0 };
+    guint seen = 0;
+
+    self->disk_generation++;
+
+    for (const gchar *line = data; line; line = proc_next_line(line)) {
+        // Formato: "   8       0 sda 1234 56 ..."
+        guint64 major, minor;
+        const gchar *p = proc_parse_u64(line, &major);
+        p = proc_parse_u64(p, &minor);
+
+        const gchar *name = proc_skip_spaces(p);
+        const gchar *end = name;
+        while (*end && *end != ' ' && *end != '\n') end++;
+
+        gsize name_len = end - name;
+        if (name_len == 0 || name_len >= DEVICE_NAME_MAX) continue;
+
+        DiskDevice *device = lookup_disk(self, name, name_len);
+        device->generation = self->disk_generation;
+        seen++;
+
+        // Los excluidos (loop, zram...) no pasan del nombre
+        if (!device->info.included) continue;
+
+        guint64 fields[10];
+        p = end;
+        for (int i = 0; i < 10; i++) {
+            p = proc_parse_u64(p, &fields[i]);
+        }
+        disk_update_rates(self, device, fields, elapsed);
+
+        // La E/S de una partición ya cuenta en su disco: solo suma en los
+        // totales si el filtro deja fuera el disco. /proc/diskstats lista
+        // cada disco antes que sus particiones
+        if (device->info.partition) {
+            DiskDevice *parent = g_hash_table_lookup(self->disks, device->parent);
+            if (parent && parent->info.included) continue;
+        }
+
+        totals.read_speed += device->info.read_speed;
+        totals.write_speed += device->info.write_speed;
+        totals.read_iops += device->info.read_iops;
+        totals.write_iops += device->info.write_iops;
+        totals.busy_percent = MAX(totals.busy_percent, device->info.busy_percent);
+    }
+
+    if (seen != g_hash_table_size(self->disks)) {
+        g_hash_table_foreach_remove(self->disks, disk_is_gone, &self->disk_generation);
+    }
+
+    self->snapshot.disk = totals;
+    self->prev_disk_time = now;
+}
+
+static void read_sensor_info(SystemMonitor *self) {
+    if (!self->sysfs_sensors) {
+        self->sysfs_sensors = sysfs_sensors_new();
+    }
+
+    sysfs_sensors_read(self->sysfs_sensors, &self->snapshot.sensors);
+}
+
+// Leer todas las fuentes indicadas en una sola pasada; devuelve las que ya
+// están listas (las asíncronas se publican al completarse)
+static guint sample_sources(SystemMonitor *self, guint sources) {
+    guint ready = sources;
+
+    if (self->read_hook) {
+        self->read_hook(sources, self->read_hook_data);
+    }
+
+    if (sources & (SYSTEM_MONITOR_CPU | SYSTEM_MONITOR_CPU_CORES)) {
+        read_cpu_info(self, (sources & SYSTEM_MONITOR_CPU_CORES) != 0);
+    }
+    if (sources & SYSTEM_MONITOR_MEMORY) read_memory_info(self);
+    if (sources & SYSTEM_MONITOR_PRESSURE) read_pressure_info(self);
+    if (sources & SYSTEM_MONITOR_DISK) read_disk_info(self);
+    if (sources & SYSTEM_MONITOR_SENSORS) read_sensor_info(self);
+    if (sources & SYSTEM_MONITOR_NETWORK) {
+        if (self->netlink) {
+            request_network_info(self);
+            ready &= ~SYSTEM_MONITOR_NETWORK;
+        } else {
+            read_network_info(self);
+        }
+    }
+
+    return ready;
+}
+
+static void published_snapshot_free(PublishedSnapshot *snapshot) {
+    if (!snapshot) return;
+
+    if (snapshot->interfaces) {
+        g_hash_table_unref(snapshot->interfaces);
+    }
+    if (snapshot->disks) {
+        g_hash_table_unref(snapshot->disks);
+    }
+    g_free(snapshot->core_usage);
+    g_free(snapshot->sensors);
+    g_free(snapshot);
+}
+
+static GHashTable *copy_interfaces(GHashTable *interfaces) {
+    GHashTable *copy = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, interfaces);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        NetInterface *iface = g_new(NetInterface, 1);
+
+        *iface = *(NetInterface *)value;
+        iface->info.name = iface->name;
+        g_hash_table_insert(copy, iface->name, iface);
+    }
+
+    return copy;
+}
+
+static GHashTable *copy_disks(GHashTable *disks) {
+    GHashTable *copy = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+    GHashTableIter iter;
+    gpointer value;
+
+    g_hash_table_iter_init(&iter, disks);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        DiskDevice *device = g_new(DiskDevice, 1);
+
+        *device = *(DiskDevice *)value;
+        device->info.name = device->name;
+        g_hash_table_insert(copy, device->name, device);
+    }
+
+    return copy;
+}
+
+// Hilo de muestreo: copiar las lecturas en una muestra inmutable y dejarla
+// para el hilo principal. Si la anterior no se llegó a recoger se descarta;
+// las fuentes que cubría se acumulan con las nuevas
+static void publish_snapshot(SystemMonitor *self, guint sources) {
+    PublishedSnapshot *snapshot = g_new0(PublishedSnapshot, 1);
+    guint n_cores = self->snapshot.cpu.n_cores;
+
+    snapshot->data = self->snapshot;
+    if (n_cores > 0) {
+        snapshot->core_usage = g_new(float, n_cores);
+        memcpy(snapshot->core_usage, self->snapshot.cpu.core_usage, n_cores * sizeof(float));
+    }
+    snapshot->data.cpu.core_usage = snapshot->core_usage;
+
+    // Las etiquetas son del lector de sensores, que vive tanto como el monitor
+    guint n_sensors = self->snapshot.sensors.n_sensors;
+    if (n_sensors > 0) {
+        snapshot->sensors = g_new(SystemMonitorSensor, n_sensors);
+        memcpy(snapshot->sensors, self->snapshot.sensors.sensors, n_sensors * sizeof(SystemMonitorSensor));
+    }
+    snapshot->data.sensors.sensors = snapshot->sensors;
+
+    if (!self->published_interfaces || (sources & SYSTEM_MONITOR_NETWORK)) {
+        if (self->published_interfaces) {
+            g_hash_table_unref(self->published_interfaces);
+        }
+        self->published_interfaces = copy_interfaces(self->interfaces);
+    }
+    snapshot->interfaces = g_hash_table_ref(self->published_interfaces);
+
+    if (!self->published_disks || (sources & SYSTEM_MONITOR_DISK)) {
+        if (self->published_disks) {
+            g_hash_table_unref(self->published_disks);
+        }
+        self->published_disks = copy_disks(self->disks);
+    }
+    snapshot->disks = g_hash_table_ref(self->published_disks);
+
+    // Los intervalos viajan como totales: si esta muestra sustituye a otra sin
+    // recoger, la diferencia con la anterior recogida sigue incluyéndolos
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        if (sources & (1u << i)) {
+            self->total_periods[i] += self->sampling_periods[i];
+            self->sampling_periods[i] = 0;
+        }
+    }
+    memcpy(snapshot->periods, self->total_periods, sizeof(snapshot->periods));
+
+    snapshot_slot_publish(&self->published, snapshot, sources);
+    wakeup_source_signal(self->publish_source);
+}
+
+static gboolean on_sample_requested(gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+    guint sources = g_atomic_int_and(&self->requested_sources, 0);
+
+    // La red con netlink se publica más tarde: los intervalos esperan hasta entonces
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        if (sources & (1u << i)) {
+            self->sampling_periods[i] += g_atomic_int_and(&self->requested_periods[i], 0);
+        }
+    }
+
+    if (sources) {
+        guint ready = sample_sources(self, sources);
+        if (ready) {
+            publish_snapshot(self, ready);
+        }
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static gpointer sampler_thread(gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+
+    g_main_context_push_thread_default(self->worker_context);
+    g_main_loop_run(self->worker_loop);
+    g_main_context_pop_thread_default(self->worker_context);
+
+    return NULL;
+}
+
+// Desde el propio contexto del hilo, por si aún no ha entrado en el bucle
+static gboolean stop_sampler_thread(gpointer user_data) {
+    g_main_loop_quit(SYSTEM_MONITOR(user_data)->worker_loop);
+    return G_SOURCE_REMOVE;
+}
+
+// Hilo principal: pedir una lectura; un /proc lento solo retrasa la respuesta.
+// `periods` son los intervalos base que cubre para cada fuente pedida: 0 en
+// las lecturas extra, que no deben añadir muestras a los historiales
+static void request_sample(SystemMonitor *self, guint sources, const guint *periods) {
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        if ((sources & (1u << i)) && periods[i] > 0) {
+            g_atomic_int_add((gint *)&self->requested_periods[i], (gint)periods[i]);
+        }
+    }
+
+    // Después de los intervalos: el hilo de muestreo los recoge al ver la máscara
+    g_atomic_int_or(&self->requested_sources, sources);
+    wakeup_source_signal(self->request_source);
+}
+// Valor representativo de una fuente para decidir si ha cambiado
+static double source_value(SystemMonitor *self, guint index) {
+    const SystemMonitorSnapshot *snapshot = &self->current->data;
+
+    switch (1u << index) {
+    case SYSTEM_MONITOR_MEMORY:
+        return snapshot->memory.used_percent;
+    case SYSTEM_MONITOR_NETWORK:
+        return snapshot->network.rx_speed + snapshot->network.tx_speed;
+    case SYSTEM_MONITOR_PRESSURE:
+        return snapshot->pressure.memory.some_avg10 + snapshot->pressure.cpu.some_avg10;
+    case SYSTEM_MONITOR_DISK:
+        return snapshot->disk.read_speed + snapshot->disk.write_speed;
+    case SYSTEM_MONITOR_SENSORS:
+        return snapshot->sensors.temperature + snapshot->sensors.battery;
+    default:
+        return snapshot->cpu.usage_percent;
+    }
+}
+
+static gboolean source_is_stable(guint index, double reference, double value) {
+    if ((1u << index) & (SYSTEM_MONITOR_NETWORK | SYSTEM_MONITOR_DISK)) {
+        return fabs(value - reference) <= MAX(STABLE_NET_KBPS, reference * STABLE_NET_RATIO);
+    }
+    return fabs(value - reference) <= STABLE_PERCENT;
+}
+
+static guint effective_interval(const SourceState *state) {
+    guint level = state->visible == 0 ? HIDDEN_BACKOFF_LEVEL : state->level;
+    guint64 interval = (guint64)state->interval_ms << level;
+
+    return (guint)MAX(state->interval_ms, MIN(interval, MAX_INTERVAL_MS));
+}
+
+// Ajustar el nivel de espera según la última lectura; TRUE si cambia el intervalo
+static gboolean update_backoff(SystemMonitor *self, guint index) {
+    SourceState *state = &self->sources[index];
+    guint before = effective_interval(state);
+    double value = source_value(self, index);
+
+    if (source_is_stable(index, state->reference, value)) {
+        if (++state->stable_samples >= STABLE_SAMPLES && state->level < MAX_BACKOFF_LEVEL) {
+            state->level++;
+            state->stable_samples = 0;
+        }
+    } else {
+        state->level = 0;
+        state->stable_samples = 0;
+        state->reference = value;
+    }
+
+    return effective_interval(state) != before;
+}
+
+static void system_monitor_reschedule(SystemMonitor *self);
+
+static gboolean on_sample_tick(gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+    gint64 now = g_get_monotonic_time();
+    gint64 slack = (gint64)self->tick_ms * 500; // medio tick, en µs
+    guint periods[SOURCE_COUNT] = { 0 };
+    guint due = 0;
+
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        SourceState *state = &self->sources[i];
+        if (state->subscribers > 0 && state->next_due <= now + slack) {
+            due |= 1u << i;
+        }
+    }
+
+    if (!due) return G_SOURCE_CONTINUE;
+
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        if (!(due & (1u << i))) continue;
+
+        SourceState *state = &self->sources[i];
+        gint64 base = (gint64)state->interval_ms * 1000;
+
+        periods[i] = MAX(1, (now - state->last_sample + base / 2) / base);
+        state->last_sample = now;
+        state->next_due = now + (gint64)effective_interval(state) * 1000;
+    }
+
+    // La espera se ajusta cuando llega la muestra, en on_snapshot_published
+    request_sample(self, due, periods);
+
+    return G_SOURCE_CONTINUE;
+}
+
+// Recoger la última muestra del hilo de muestreo, ajustar la espera de las
+// fuentes que trae y avisar a los widgets
+static gboolean on_snapshot_published(gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+    guint published;
+    PublishedSnapshot *snapshot = snapshot_slot_take(&self->published, &published);
+    gboolean reschedule = FALSE;
+    guint sources = 0;
+
+    // Los intervalos se cuentan con cada muestra recogida, aunque su fuente
+    // llegue en la máscara de una recogida posterior
+    if (snapshot) {
+        for (guint i = 0; i < SOURCE_COUNT; i++) {
+            self->sources[i].unreported += snapshot->periods[i] - self->current->periods[i];
+        }
+        published_snapshot_free(self->current);
+        self->current = snapshot;
+    }
+
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        SourceState *state = &self->sources[i];
+        if (!(published & (1u << i))) continue;
+
+        state->periods = (guint)state->unreported;
+        state->unreported = 0;
+        if (state->subscribers == 0) continue;
+
+        if (update_backoff(self, i)) {
+            state->next_due = state->last_sample + (gint64)effective_interval(state) * 1000;
+            reschedule = TRUE;
+        }
+        sources |= 1u << i;
+    }
+
+    if (reschedule) {
+        system_monitor_reschedule(self);
+    }
+
+    if (sources) {
+        g_signal_emit(self, signals[SIGNAL_UPDATED], 0, sources);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static guint gcd(guint a, guint b) {
+    while (b) {
+        guint t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// El tick es el máximo común divisor de los intervalos efectivos, así todas
+// las fuentes despiertan juntas y nunca hay más de un temporizador; cuando
+// las fuentes se relajan el tick crece y el proceso despierta menos
+static void system_monitor_reschedule(SystemMonitor *self) {
+    guint tick = 0;
+
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        if (self->sources[i].subscribers == 0) continue;
+
+        guint interval = effective_interval(&self->sources[i]);
+        tick = tick ? gcd(tick, interval) : interval;
+    }
+
+    if (tick == self->tick_ms && (tick == 0 || self->timeout_id > 0)) return;
+
+    if (self->timeout_id > 0) {
+        timebase_remove(self->timeout_id);
+        self->timeout_id = 0;
+    }
+
+    self->tick_ms = tick;
+
+    if (tick == 0) return;
+
+    // Alineado al reloj de pared: comparte despertar con el reloj y el resto del
+    // panel. on_sample_tick ya acepta medio tick de margen, así que esa es la tolerancia
+    self->timeout_id = timebase_add(tick, tick / 2, on_sample_tick, self);
+}
+
+static void source_reset_backoff(SystemMonitor *self, SourceState *state);
+
+// El kernel superó el umbral de espera por memoria: leer ya memoria y presión
+// y volver al intervalo base mientras dure, sin muestrear más rápido de normal
+static gboolean on_pressure_trigger(gpointer user_data) {
+    SystemMonitor *self = SYSTEM_MONITOR(user_data);
+    guint sources = 0;
+
+    for (guint i = 0; i < SOURCE_COUNT; i++) {
+        guint source = 1u << i;
+        SourceState *state = &self->sources[i];
+
+        if (!(source & (SYSTEM_MONITOR_MEMORY | SYSTEM_MONITOR_PRESSURE)) || state->subscribers == 0) continue;
+
+        source_reset_backoff(self, state);
+        sources |= source;
+    }
+
+    // Lectura extra: no cuenta como intervalo para los historiales
+    if (sources) {
+        static const guint no_periods[SOURCE_COUNT] = { 0 };
+        request_sample(self, sources, no_periods);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void pressure_trigger_open(SystemMonitor *self) {
+    // Si el kernel invalida el trigger la fuente se destruye sola y
+    // seguimos solo con el temporizador
+    self->psi_source = psi_trigger_source_new("/proc/pressure/memory", PSI_MEMORY_TRIGGER);
+    if (!self->psi_source) return;
+
+    g_source_set_callback(self->psi_source, on_pressure_trigger, self, NULL);
+    g_source_attach(self->psi_source, NULL);
+}
+
+static void pressure_trigger_close(SystemMonitor *self) {
+    if (self->psi_source) {
+        g_source_destroy(self->psi_source);
+        g_source_unref(self->psi_source);
+        self->psi_source = NULL;
+    }
+}
+
+void system_monitor_subscribe(SystemMonitor *self, SystemMonitorSource source, guint interval_ms) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    SourceState *state = &self->sources[source_index(source)];
+    interval_ms = MAX(interval_ms, 100);
+
+    if (state->subscribers == 0 || interval_ms < state->interval_ms) {
+        state->interval_ms = interval_ms;
+    }
+
+    // Primera lectura para inicializar los deltas
+    if (state->subscribers++ == 0) {
+        guint index = source_index(source);
+        gint64 now = g_get_monotonic_time();
+
+        guint periods[SOURCE_COUNT] = { 0 };
+        periods[index] = 1;
+        request_sample(self, source, periods);
+
+        state->level = 0;
+        state->stable_samples = 0;
+        state->reference = source_value(self, index);
+        state->last_sample = now;
+        state->next_due = now + (gint64)effective_interval(state) * 1000;
+
+        if (source == SYSTEM_MONITOR_PRESSURE) {
+            pressure_trigger_open(self);
+        }
+    }
+
+    system_monitor_reschedule(self);
+}
+
+void system_monitor_unsubscribe(SystemMonitor *self, SystemMonitorSource source) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    SourceState *state = &self->sources[source_index(source)];
+    if (state->subscribers == 0) return;
+
+    state->subscribers--;
+    if (state->subscribers == 0) {
+        state->visible = 0;
+
+        if (source == SYSTEM_MONITOR_PRESSURE) {
+            pressure_trigger_close(self);
+        }
+    }
+    system_monitor_reschedule(self);
+}
+
+// Volver al intervalo base sin esperar al plazo largo calculado mientras estaba relajada
+static void source_reset_backoff(SystemMonitor *self, SourceState *state) {
+    state->level = 0;
+    state->stable_samples = 0;
+
+    gint64 next_due = g_get_monotonic_time() + (gint64)state->interval_ms * 1000;
+    state->next_due = MIN(state->next_due, next_due);
+
+    system_monitor_reschedule(self);
+}
+
+void system_monitor_boost(SystemMonitor *self, SystemMonitorSource source) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    SourceState *state = &self->sources[source_index(source)];
+    if (state->subscribers == 0 || state->level == 0) return;
+
+    source_reset_backoff(self, state);
+}
+
+void system_monitor_set_visible(SystemMonitor *self, SystemMonitorSource source, gboolean visible) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    SourceState *state = &self->sources[source_index(source)];
+    if (state->subscribers == 0) return;
+
+    if (visible) {
+        if (state->visible++ == 0) {
+            // Vuelve a estar en pantalla: recuperar el intervalo base enseguida
+            source_reset_backoff(self, state);
+        }
+    } else if (state->visible > 0 && --state->visible == 0) {
+        system_monitor_reschedule(self);
+    }
+}
+
+guint system_monitor_get_periods(SystemMonitor *self, SystemMonitorSource source) {
+    g_return_val_if_fail(SYSTEM_IS_MONITOR(self), 1);
+    return self->sources[source_index(source)].periods;
+}
+
+const SystemMonitorSnapshot *system_monitor_get_snapshot(SystemMonitor *self) {
+    g_return_val_if_fail(SYSTEM_IS_MONITOR(self), NULL);
+    return &self->current->data;
+}
+
+static gchar **parse_pattern_list(const gchar *patterns) {
+    if (!patterns || !*patterns) return NULL;
+
+    gchar **list = g_strsplit(patterns, ",", -1);
+    for (gint i = 0; list[i]; i++) {
+        g_strstrip(list[i]);
+    }
+    return list;
+}
+
+// Cambios de configuración de red: se aplican en el hilo de muestreo, que es
+// el dueño del estado de las interfaces y del socket netlink
+typedef struct {
+    SystemMonitor *self;
+    gchar **include;
+    gchar **exclude;
+    gboolean partitions;
+} DeviceFilter;
+
+typedef struct {
+    SystemMonitor *self;
+    SystemMonitorNetBackend backend;
+} NetworkBackend;
+
+typedef struct {
+    SystemMonitor *self;
+    SystemMonitorReadHook hook;
+    gpointer user_data;
+} ReadHook;
+
+static gboolean apply_network_filter(gpointer user_data) {
+    DeviceFilter *filter = user_data;
+    SystemMonitor *self = filter->self;
+
+    g_strfreev(self->net_include);
+    g_strfreev(self->net_exclude);
+    self->net_include = g_steal_pointer(&filter->include);
+    self->net_exclude = g_steal_pointer(&filter->exclude);
+
+    // Reevaluar las interfaces conocidas; los contadores se conservan
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, self->interfaces);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        NetInterface *iface = value;
+        iface->info.included = interface_is_included(self, iface->name);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static void device_filter_free(gpointer data) {
+    DeviceFilter *filter = data;
+
+    g_strfreev(filter->include);
+    g_strfreev(filter->exclude);
+    g_free(filter);
+}
+
+void system_monitor_set_network_filter(SystemMonitor *self, const gchar *include, const gchar *exclude) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    DeviceFilter *filter = g_new0(DeviceFilter, 1);
+    filter->self = self;
+    filter->include = parse_pattern_list(include);
+    filter->exclude = parse_pattern_list(exclude);
+
+    g_main_context_invoke_full(self->worker_context, G_PRIORITY_DEFAULT,
+                               apply_network_filter, filter, device_filter_free);
+}
+
+static gboolean apply_disk_filter(gpointer user_data) {
+    DeviceFilter *filter = user_data;
+    SystemMonitor *self = filter->self;
+
+    g_strfreev(self->disk_include);
+    g_strfreev(self->disk_exclude);
+    self->disk_include = g_steal_pointer(&filter->include);
+    self->disk_exclude = g_steal_pointer(&filter->exclude);
+    self->disk_partitions = filter->partitions;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, self->disks);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        DiskDevice *device = value;
+        device->info.included = device_is_included(self, device);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+void system_monitor_set_disk_filter(SystemMonitor *self, const gchar *include, const gchar *exclude,
+                                    gboolean partitions) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    DeviceFilter *filter = g_new0(DeviceFilter, 1);
+    filter->self = self;
+    filter->include = parse_pattern_list(include);
+    filter->exclude = parse_pattern_list(exclude);
+    filter->partitions = partitions;
+
+    g_main_context_invoke_full(self->worker_context, G_PRIORITY_DEFAULT,
+                               apply_disk_filter, filter, device_filter_free);
+}
+
+static gboolean apply_network_backend(gpointer user_data) {
+    NetworkBackend *change = user_data;
+    SystemMonitor *self = change->self;
+
+    gboolean use_netlink = change->backend == SYSTEM_MONITOR_NET_NETLINK;
+    if (use_netlink == (self->netlink != NULL)) return G_SOURCE_REMOVE;
+
+    if (use_netlink) {
+        // Si no hay socket netlink se sigue con /proc/net/dev
+        self->netlink = netlink_stats_new(self->worker_context, on_interface_counters, on_netlink_done, self);
+    } else {
+        netlink_stats_free(self->netlink);
+        self->netlink = NULL;
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+void system_monitor_set_network_backend(SystemMonitor *self, SystemMonitorNetBackend backend) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    NetworkBackend *change = g_new0(NetworkBackend, 1);
+    change->self = self;
+    change->backend = backend;
+
+    g_main_context_invoke_full(self->worker_context, G_PRIORITY_DEFAULT,
+                               apply_network_backend, change, g_free);
+}
+
+static gboolean apply_read_hook(gpointer user_data) {
+    ReadHook *change = user_data;
+
+    change->self->read_hook = change->hook;
+    change->self->read_hook_data = change->user_data;
+
+    return G_SOURCE_REMOVE;
+}
+
+void system_monitor_set_read_hook(SystemMonitor *self, SystemMonitorReadHook hook, gpointer user_data) {
+    g_return_if_fail(SYSTEM_IS_MONITOR(self));
+
+    ReadHook *change = g_new0(ReadHook, 1);
+    change->self = self;
+    change->hook = hook;
+    change->user_data = user_data;
+
+    g_main_context_invoke_full(self->worker_context, G_PRIORITY_DEFAULT,
+                               apply_read_hook, change, g_free);
+}
+
+GHashTable *system_monitor_get_interfaces(SystemMonitor *self) {
+    g_return_val_if_fail(SYSTEM_IS_MONITOR(self), NULL);
+    return self->current->interfaces;
+}
+
+GHashTable *system_monitor_get_disks(SystemMonitor *self) {
+    g_return_val_if_fail(SYSTEM_IS_MONITOR(self), NULL);
+    return self->current->disks;
+}
+
+const gchar *system_monitor_scale_speed(double *speed) {
+    if (*speed > 1024) {
+        *speed /= 1024.0;
+        return "MB/s";
+    }
+    return "KB/s";
+}
+
+static void system_monitor_dispose(GObject *object) {
+    SystemMonitor *self = SYSTEM_MONITOR(object);
+
+    if (self->timeout_id > 0) {
+        timebase_remove(self->timeout_id);
+        self->timeout_id = 0;
+    }
+
+    pressure_trigger_close(self);
+
+    // Parar el hilo antes de tocar su estado
+    if (self->worker) {
+        g_main_context_invoke(self->worker_context, stop_sampler_thread, self);
+        g_thread_join(self->worker);
+        self->worker = NULL;
+    }
+
+    if (self->netlink) {
+        netlink_stats_free(self->netlink);
+        self->netlink = NULL;
+    }
+
+    if (self->request_source) {
+        g_source_destroy(self->request_source);
+        g_source_unref(self->request_source);
+        self->request_source = NULL;
+    }
+    if (self->publish_source) {
+        g_source_destroy(self->publish_source);
+        g_source_unref(self->publish_source);
+        self->publish_source = NULL;
+    }
+
+    G_OBJECT_CLASS(system_monitor_parent_class)->dispose(object);
+}
+
+static void system_monitor_finalize(GObject *object) {
+    SystemMonitor *self = SYSTEM_MONITOR(object);
+
+    proc_file_close(self->stat_file);
+    proc_file_close(self->meminfo_file);
+    proc_file_close(self->netdev_file);
+    proc_file_close(self->psi_memory_file);
+    proc_file_close(self->psi_cpu_file);
+    proc_file_close(self->diskstats_file);
+
+    g_free(self->cores.total);
+    g_free(self->cores.idle);
+    g_free(self->cores.prev_total);
+    g_free(self->cores.prev_idle);
+    g_free(self->cores.usage);
+
+    g_hash_table_destroy(self->interfaces);
+    if (self->published_interfaces) {
+        g_hash_table_unref(self->published_interfaces);
+    }
+    g_strfreev(self->net_include);
+    g_strfreev(self->net_exclude);
+
+    g_hash_table_destroy(self->disks);
+    if (self->published_disks) {
+        g_hash_table_unref(self->published_disks);
+    }
+    g_strfreev(self->disk_include);
+    g_strfreev(self->disk_exclude);
+
+    snapshot_slot_clear(&self->published);
+    published_snapshot_free(self->current);
+    sysfs_sensors_free(self->sysfs_sensors);
+    g_main_loop_unref(self->worker_loop);
+    g_main_context_unref(self->worker_context);
+
+    G_OBJECT_CLASS(system_monitor_parent_class)->finalize(object);
+}
+
+static void system_monitor_init(SystemMonitor *self) {
+    // La clave es el nombre guardado dentro de la propia interfaz
+    self->interfaces = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+    self->net_exclude = parse_pattern_list("lo");
+    self->disks = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_free);
+
+    // Hasta la primera lectura se publica una muestra vacía
+    self->current = g_new0(PublishedSnapshot, 1);
+    self->current->interfaces = g_hash_table_new(g_str_hash, g_str_equal);
+    self->current->disks = g_hash_table_new(g_str_hash, g_str_equal);
+
+    snapshot_slot_init(&self->published, (GDestroyNotify)published_snapshot_free);
+    self->publish_source = wakeup_source_new();
+    g_source_set_callback(self->publish_source, on_snapshot_published, self, NULL);
+    g_source_attach(self->publish_source, NULL);
+
+    // Las lecturas de /proc pueden bloquearse con el sistema bajo presión de
+    // E/S; se hacen en un hilo propio para que el panel siga respondiendo
+    self->worker_context = g_main_context_new();
+    self->worker_loop = g_main_loop_new(self->worker_context, FALSE);
+
+    self->request_source = wakeup_source_new();
+    g_source_set_callback(self->request_source, on_sample_requested, self, NULL);
+    g_source_attach(self->request_source, self->worker_context);
+
+    self->worker = g_thread_new("system-monitor", sampler_thread, self);
+}
+
+static void system_monitor_class_init(SystemMonitorClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    object_class->dispose = system_monitor_dispose;
+    object_class->finalize = system_monitor_finalize;
+
+    // Se emite una vez por tick con la máscara de fuentes actualizadas
+    signals[SIGNAL_UPDATED] = g_signal_new("updated",
+                                           G_TYPE_FROM_CLASS(klass),
+                                           G_SIGNAL_RUN_LAST,
+                                           0, NULL, NULL, NULL,
+                                           G_TYPE_NONE, 1, G_TYPE_UINT);
+}
+
+SystemMonitor *system_monitor_get_default(void) {
+    static SystemMonitor *default_monitor = NULL;
+
+    if (!default_monitor) {
+        default_monitor = g_object_new(SYSTEM_TYPE_MONITOR, NULL);
+    }
+
+    return default_monitor;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+// Fuentes de datos que puede muestrear el monitor del sistema
+typedef enum {
+    SYSTEM_MONITOR_CPU     = 1 << 0,
+    SYSTEM_MONITOR_MEMORY  = 1 << 1,
+    SYSTEM_MONITOR_NETWORK = 1 << 2,
+    SYSTEM_MONITOR_CPU_CORES = 1 << 3,
+    SYSTEM_MONITOR_PRESSURE = 1 << 4,
+    SYSTEM_MONITOR_DISK    = 1 << 5,
+    SYSTEM_MONITOR_SENSORS = 1 << 6,
+} SystemMonitorSource;
+
+typedef struct {
+    double usage_percent;
+
+    // Solo con SYSTEM_MONITOR_CPU_CORES; válido hasta la siguiente muestra
+    guint n_cores;
+    const float *core_usage;
+} SystemMonitorCpu;
+
+typedef struct {
+    guint64 total_kb;
+    guint64 used_kb;
+    double used_percent;
+
+    guint64 swap_total_kb;
+    guint64 swap_used_kb;
+    guint64 zswap_kb;       // tamaño del pool comprimido
+    guint64 zswapped_kb;    // páginas guardadas en él, sin comprimir
+} SystemMonitorMemory;
+
+// Pressure stall information: % de tiempo con tareas esperando (media de 10 s)
+typedef struct {
+    double some_avg10;      // alguna tarea esperando
+    double full_avg10;      // todas las tareas esperando
+} SystemMonitorPsi;
+
+typedef struct {
+    gboolean available;     // FALSE si el kernel no tiene PSI
+    SystemMonitorPsi memory;
+    SystemMonitorPsi cpu;
+} SystemMonitorPressure;
+
+// De dónde se leen los contadores de red
+typedef enum {
+    SYSTEM_MONITOR_NET_PROC,        // parsear /proc/net/dev
+    SYSTEM_MONITOR_NET_NETLINK,     // RTM_GETLINK en binario, asíncrono
+} SystemMonitorNetBackend;
+
+// Totales de las interfaces que pasan el filtro de red
+typedef struct {
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    double rx_speed;    // KB/s
+    double tx_speed;    // KB/s
+} SystemMonitorNetwork;
+
+typedef struct {
+    const gchar *name;
+    gboolean included;  // si cuenta en los totales (filtros include/exclude)
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    double rx_speed;    // KB/s
+    double tx_speed;    // KB/s
+} SystemMonitorInterface;
+
+// Totales de los dispositivos de bloque que pasan el filtro de disco
+typedef struct {
+    double read_speed;      // KB/s
+    double write_speed;     // KB/s
+    double read_iops;
+    double write_iops;
+    double busy_percent;    // del dispositivo más ocupado: % del tiempo con E/S en curso
+} SystemMonitorDisk;
+
+typedef struct {
+    const gchar *name;
+    gboolean included;      // si pasa los filtros; una partición incluida solo suma si su disco no lo está
+    gboolean partition;
+    double read_speed;      // KB/s
+    double write_speed;     // KB/s
+    double read_iops;
+    double write_iops;
+    double busy_percent;
+} SystemMonitorDevice;
+
+// Sensores de /sys con valor propio; la frecuencia de CPU solo va en el resumen
+typedef enum {
+    SYSTEM_MONITOR_SENSOR_TEMPERATURE,  // °C
+    SYSTEM_MONITOR_SENSOR_BATTERY,      // % de carga
+} SystemMonitorSensorKind;
+
+typedef struct {
+    SystemMonitorSensorKind kind;
+    const gchar *label;     // "coretemp: Package id 0", "BAT0"...
+    gboolean valid;         // FALSE si la última lectura falló
+    double value;
+    gboolean charging;      // solo baterías
+} SystemMonitorSensor;
+
+// Resumen de todos los sensores; cada has_* es FALSE si no hay ninguno de ese tipo
+typedef struct {
+    gboolean has_temperature;
+    double temperature;     // el sensor más caliente
+    gboolean has_frequency;
+    double frequency;       // MHz, media de las políticas de cpufreq
+    gboolean has_battery;
+    double battery;         // media de las baterías del sistema
+    gboolean charging;
+
+    // Los sensores se descubren una vez; la lista no cambia, solo sus valores
+    guint n_sensors;
+    const SystemMonitorSensor *sensors;
+} SystemMonitorSensors;
+
+// Última muestra publicada para todas las fuentes
+typedef struct {
+    SystemMonitorCpu cpu;
+    SystemMonitorMemory memory;
+    SystemMonitorNetwork network;
+    SystemMonitorPressure pressure;
+    SystemMonitorDisk disk;
+    SystemMonitorSensors sensors;
+} SystemMonitorSnapshot;
+
+#define SYSTEM_TYPE_MONITOR (system_monitor_get_type())
+G_DECLARE_FINAL_TYPE(SystemMonitor, system_monitor, SYSTEM, MONITOR, GObject)
+
+// Instancia compartida por todos los widgets de monitorización
+SystemMonitor *system_monitor_get_default(void);
+
+// Los widgets se suscriben a una fuente con el intervalo que necesitan;
+// todas las fuentes activas se leen en el mismo tick del temporizador
+void system_monitor_subscribe(SystemMonitor *self, SystemMonitorSource source, guint interval_ms);
+void system_monitor_unsubscribe(SystemMonitor *self, SystemMonitorSource source);
+
+// El intervalo es adaptativo: se alarga si las lecturas no cambian o si ningún
+// suscriptor está visible, y vuelve al base con un cambio o al pedir atención
+void system_monitor_set_visible(SystemMonitor *self, SystemMonitorSource source, gboolean visible);
+void system_monitor_boost(SystemMonitor *self, SystemMonitorSource source);
+
+// Cuántos intervalos base cubre la última emisión de "updated" de la fuente,
+// para que los historiales sigan teniendo una muestra por intervalo. Es 0 si
+// solo llegaron lecturas extra fuera del temporizador (triggers de PSI)
+guint system_monitor_get_periods(SystemMonitor *self, SystemMonitorSource source);
+
+// Las lecturas se hacen en un hilo propio y el hilo principal solo recoge la
+// última muestra al emitir "updated"; lo devuelto por get_snapshot y
+// get_interfaces es inmutable y válido hasta la siguiente emisión
+const SystemMonitorSnapshot *system_monitor_get_snapshot(SystemMonitor *self);
+
+// Patrones glob separados por comas; include vacío equivale a todas las interfaces
+void system_monitor_set_network_filter(SystemMonitor *self, const gchar *include, const gchar *exclude);
+
+void system_monitor_set_network_backend(SystemMonitor *self, SystemMonitorNetBackend backend);
+
+// Interfaces vistas en la última lectura: nombre → SystemMonitorInterface (solo lectura)
+GHashTable *system_monitor_get_interfaces(SystemMonitor *self);
+
+// Igual que el filtro de red; las particiones solo se leen con `partitions`
+// y solo suman en los totales si su disco no pasa el filtro (si pasa, los
+// totales ya incluyen su E/S)
+void system_monitor_set_disk_filter(SystemMonitor *self, const gchar *include, const gchar *exclude,
+                                    gboolean partitions);
+
+// Dispositivos de /proc/diskstats: nombre → SystemMonitorDevice (solo lectura)
+GHashTable *system_monitor_get_disks(SystemMonitor *self);
+
+// Solo para pruebas: función que el hilo de muestreo llama antes de cada
+// lectura con las fuentes que va a leer, para simular un /proc lento
+typedef void (*SystemMonitorReadHook)(guint sources, gpointer user_data);
+void system_monitor_set_read_hook(SystemMonitor *self, SystemMonitorReadHook hook, gpointer user_data);
+
+// Pasar una velocidad de KB/s a MB/s cuando el valor es grande; devuelve la unidad
+const gchar *system_monitor_scale_speed(double *speed);
+
+G_END_DECLS
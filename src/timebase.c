@@ -0,0 +1,147 @@
+#include "timebase.h"
+#include "event_source.h"
+
+typedef struct {
+    guint id;
+    guint interval_ms;
+    guint tolerance_ms;
+    gint64 next_fire;   // tiempo real (µs) del siguiente límite
+    GSourceFunc func;   // NULL si se eliminó durante el despacho
+    gpointer user_data;
+} TimebaseEntry;
+
+static GPtrArray *entries = NULL;
+static GSource *deadline = NULL;   // timerfd; sin él se usa g_timeout_add
+static guint timeout_id = 0;
+static guint last_id = 0;
+static gboolean dispatching = FALSE;
+
+static gint64 next_boundary(gint64 now, guint interval_ms) {
+    gint64 interval = (gint64)interval_ms * 1000;
+    return (now / interval + 1) * interval;
+}
+
+static gboolean on_timebase_timeout(gpointer user_data);
+
+static void timebase_disarm(void) {
+    if (timeout_id > 0) {
+        g_source_remove(timeout_id);
+        timeout_id = 0;
+    }
+    if (deadline) {
+        deadline_source_set_deadline(deadline, -1, 0);
+    }
+}
+
+// Un único temporizador de un disparo hasta el límite más cercano
+static void timebase_arm(void) {
+    timebase_disarm();
+
+    if (dispatching || !entries || entries->len == 0) return;
+
+    gint64 now = g_get_real_time();
+    gint64 earliest = G_MAXINT64;
+    gint64 latest = G_MAXINT64;
+
+    for (guint i = 0; i < entries->len; i++) {
+        TimebaseEntry *entry = g_ptr_array_index(entries, i);
+
+        // Si el reloj se atrasó, no esperar al límite antiguo
+        if (entry->next_fire - now > (gint64)entry->interval_ms * 1000) {
+            entry->next_fire = next_boundary(now, entry->interval_ms);
+        }
+        earliest = MIN(earliest, entry->next_fire);
+        latest = MIN(latest, entry->next_fire + (gint64)entry->tolerance_ms * 1000);
+    }
+
+    // Ventana común: desde el primer límite hasta que alguna entrada se pase de su tolerancia
+    if (deadline) {
+        deadline_source_set_deadline(deadline, earliest, (guint)((latest - earliest) / 1000));
+        return;
+    }
+
+    // Redondear hacia arriba: despertar antes del límite obligaría a otro despertar
+    gint64 delay_ms = MAX(0, (earliest - now + 999) / 1000);
+    timeout_id = g_timeout_add((guint)delay_ms, on_timebase_timeout, NULL);
+}
+
+static gboolean on_timebase_timeout(gpointer user_data G_GNUC_UNUSED) {
+    gint64 now = g_get_real_time();
+
+    // El timerfd sigue vivo entre disparos; solo el fallback es de un disparo
+    gboolean oneshot = deadline == NULL;
+
+    if (oneshot) {
+        timeout_id = 0;
+    }
+    dispatching = TRUE;
+
+    // Los callbacks pueden añadir entradas (se quedan para el siguiente
+    // límite) o eliminarlas (se marcan y se retiran al final)
+    for (guint i = 0; i < entries->len; i++) {
+        TimebaseEntry *entry = g_ptr_array_index(entries, i);
+        if (!entry->func || entry->next_fire > now) continue;
+
+        entry->next_fire = next_boundary(now, entry->interval_ms);
+        if (entry->func(entry->user_data) == G_SOURCE_REMOVE) {
+            entry->func = NULL;
+        }
+    }
+
+    for (guint i = entries->len; i-- > 0;) {
+        TimebaseEntry *entry = g_ptr_array_index(entries, i);
+        if (!entry->func) {
+            g_ptr_array_remove_index(entries, i);
+        }
+    }
+
+    dispatching = FALSE;
+    timebase_arm();
+
+    return oneshot ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+
+guint timebase_add(guint interval_ms, guint tolerance_ms, GSourceFunc func, gpointer user_data) {
+    g_return_val_if_fail(interval_ms > 0 && func != NULL, 0);
+
+    if (!entries) {
+        entries = g_ptr_array_new_with_free_func(g_free);
+
+        // Plazos absolutos en tiempo real: sobreviven a la suspensión y
+        // despiertan al momento si el reloj de pared cambia
+        deadline = deadline_source_new();
+        if (deadline) {
+            g_source_set_callback(deadline, on_timebase_timeout, NULL, NULL);
+            g_source_attach(deadline, NULL);
+        }
+    }
+
+    TimebaseEntry *entry = g_new0(TimebaseEntry, 1);
+    entry->id = ++last_id;
+    entry->interval_ms = interval_ms;
+    entry->tolerance_ms = MIN(tolerance_ms, interval_ms);
+    entry->next_fire = next_boundary(g_get_real_time(), interval_ms);
+    entry->func = func;
+    entry->user_data = user_data;
+    g_ptr_array_add(entries, entry);
+
+    timebase_arm();
+    return entry->id;
+}
+
+void timebase_remove(guint id) {
+    if (!entries || id == 0) return;
+
+    for (guint i = 0; i < entries->len; i++) {
+        TimebaseEntry *entry = g_ptr_array_index(entries, i);
+        if (entry->id != id) continue;
+
+        if (dispatching) {
+            entry->func = NULL;
+        } else {
+            g_ptr_array_remove_index(entries, i);
+            timebase_arm();
+        }
+        return;
+    }
+}
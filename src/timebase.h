@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// Base de tiempo compartida por todos los temporizadores periódicos del panel.
+// Cada entrada se dispara en los múltiplos de su intervalo según el reloj de
+// pared (el minuto en punto, el segundo en punto...), de modo que las entradas
+// que coinciden se atienden en un único despertar del proceso.
+// `tolerance_ms` es cuánto puede retrasarse el disparo: las entradas cuyas
+// ventanas se solapan comparten despertar, y el plazo se alinea para que el
+// kernel lo agrupe con los de otros procesos.
+// `func` sigue el convenio de GSourceFunc: G_SOURCE_REMOVE la elimina.
+guint timebase_add(guint interval_ms, guint tolerance_ms, GSourceFunc func, gpointer user_data);
+void timebase_remove(guint id);
+
+G_END_DECLS
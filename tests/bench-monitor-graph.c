@@ -0,0 +1,74 @@
+// Coste por fotograma de MonitorGraph sobre una superficie de imagen fuera
+// de pantalla: cada fotograma añade una muestra y redibuja, en modo completo
+// e incremental y con historiales de distinto tamaño.
+// Uso: bench-monitor-graph [fotogramas]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "monitor_graph.h"
+
+#define DEFAULT_FRAMES 2000
+#define GRAPH_WIDTH 120
+#define GRAPH_HEIGHT 32
+#define GRAPH_MAX 1024.0
+
+// Valores pseudoaleatorios deterministas para que las ejecuciones sean comparables
+static void push_sample(MonitorGraph *graph, guint index) {
+    double values[2] = {
+        (double)((index * 2654435761u) >> 22) * GRAPH_MAX / 1024.0,
+        (double)((index * 40503u + 17u) % 1024u) * GRAPH_MAX / 1024.0,
+    };
+
+    monitor_graph_push(graph, values);
+}
+
+// Microsegundos por fotograma
+static double bench_graph(guint history_size, gboolean scrolling, guint frames) {
+    MonitorGraph *graph = monitor_graph_new(2, history_size, MONITOR_RING_LOG, 0.0);
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, GRAPH_WIDTH, GRAPH_HEIGHT);
+    cairo_t *cr = cairo_create(surface);
+
+    monitor_graph_set_color(graph, 0, 0.2, 0.8, 0.2);
+    monitor_graph_set_color(graph, 1, 0.8, 0.2, 0.2);
+    monitor_graph_set_fill(graph, 0, TRUE);
+    monitor_graph_set_max(graph, GRAPH_MAX);
+    monitor_graph_set_scrolling(graph, scrolling);
+
+    // Historial lleno antes de medir, como en un panel que lleva tiempo abierto
+    for (guint i = 0; i < history_size; i++) {
+        push_sample(graph, i);
+    }
+    monitor_graph_draw(graph, cr, GRAPH_WIDTH, GRAPH_HEIGHT, 1);
+
+    gint64 start = g_get_monotonic_time();
+    for (guint i = 0; i < frames; i++) {
+        push_sample(graph, history_size + i);
+        monitor_graph_draw(graph, cr, GRAPH_WIDTH, GRAPH_HEIGHT, 1);
+    }
+    cairo_surface_flush(surface);
+    double elapsed = (double)(g_get_monotonic_time() - start) / frames;
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    monitor_graph_free(graph);
+
+    return elapsed;
+}
+
+int main(int argc, char **argv) {
+    guint frames = argc > 1 ? (guint)MAX(atoi(argv[1]), 1) : DEFAULT_FRAMES;
+    static const guint history_sizes[] = { 60, 600, 3600 };
+
+    printf("%u fotogramas de %dx%d por caso\n", frames, GRAPH_WIDTH, GRAPH_HEIGHT);
+    printf("%-10s %14s %14s\n", "historial", "completo", "incremental");
+
+    for (guint i = 0; i < G_N_ELEMENTS(history_sizes); i++) {
+        guint history_size = history_sizes[i];
+        double full = bench_graph(history_size, FALSE, frames);
+        double scrolling = bench_graph(history_size, TRUE, frames);
+
+        printf("%-10u %11.2f us %11.2f us\n", history_size, full, scrolling);
+    }
+
+    return EXIT_SUCCESS;
+}
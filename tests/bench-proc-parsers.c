@@ -0,0 +1,465 @@
+// Coste por muestra de los lectores de /proc: ProcFile + parsers propios
+// frente a fopen + fscanf/sscanf (la implementación anterior).
+//
+// Mide los archivos reales del sistema y, solo el parser, textos en memoria
+// (un /proc/net/dev sintético con 10, 100 y 1000 interfaces). Con el mismo
+// número de interfaces compara ese parser con el de netlink_stats sobre
+// volcados RTM_NEWLINK y RTM_NEWSTATS sintéticos.
+// Uso: bench-proc-parsers [iteraciones]
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include "proc_reader.h"
+#include "netlink_stats.h"
+
+#define DEFAULT_ITERATIONS 20000
+
+// --- Implementación anterior, tal cual leía cada muestra ---
+
+static gboolean legacy_read_cpu(FILE *file, guint64 *total, guint64 *idle) {
+    unsigned long user, nice, system, idle_time, iowait, irq, softirq, steal;
+
+    if (fscanf(file, "cpu %lu %lu %lu %lu %lu %lu %lu %lu",
+               &user, &nice, &system, &idle_time, &iowait, &irq, &softirq, &steal) != 8) {
+        return FALSE;
+    }
+
+    *total = user + nice + system + idle_time + iowait + irq + softirq + steal;
+    *idle = idle_time + iowait;
+    return TRUE;
+}
+
+static guint64 legacy_read_meminfo(FILE *file) {
+    unsigned long mem_total = 0, mem_free = 0, mem_available = 0, buffers = 0, cached = 0;
+    char line[256];
+
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "MemTotal: %lu kB", &mem_total) == 1) continue;
+        if (sscanf(line, "MemFree: %lu kB", &mem_free) == 1) continue;
+        if (sscanf(line, "MemAvailable: %lu kB", &mem_available) == 1) continue;
+        if (sscanf(line, "Buffers: %lu kB", &buffers) == 1) continue;
+        if (sscanf(line, "Cached: %lu kB", &cached) == 1) continue;
+    }
+
+    return mem_total + mem_free + mem_available + buffers + cached;
+}
+
+static guint64 legacy_read_net_dev(FILE *file) {
+    char line[256];
+    guint64 total = 0;
+
+    if (!fgets(line, sizeof(line), file) || !fgets(line, sizeof(line), file)) {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        char interface[16];
+        unsigned long rx_bytes, tx_bytes, dummy;
+
+        if (sscanf(line, "%15[^:]: %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu",
+                   interface, &rx_bytes, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy, &dummy,
+                   &tx_bytes, &dummy) >= 10) {
+            total += rx_bytes + tx_bytes;
+        }
+    }
+
+    return total;
+}
+
+// --- Implementación actual ---
+
+static guint64 current_read_cpu(const gchar *data) {
+    guint64 total = 0, idle = 0;
+
+    if (data && strncmp(data, "cpu ", 4) == 0) {
+        proc_parse_cpu_line(data + 4, &total, &idle);
+    }
+    return total + idle;
+}
+
+static guint64 current_read_meminfo(const gchar *data) {
+    ProcMeminfo info;
+
+    proc_parse_meminfo(data, &info);
+    return info.mem_total + info.mem_free + info.mem_available + info.buffers + info.cached;
+}
+
+static void add_counters(const gchar *name G_GNUC_UNUSED, gsize name_len G_GNUC_UNUSED,
+                         guint64 rx_bytes, guint64 tx_bytes, gpointer user_data) {
+    *(guint64 *)user_data += rx_bytes + tx_bytes;
+}
+
+static guint64 current_read_net_dev(const gchar *data) {
+    guint64 total = 0;
+
+    proc_parse_net_dev(data, add_counters, &total);
+    return total;
+}
+
+// --- Medición ---
+
+typedef enum {
+    SOURCE_CPU,
+    SOURCE_MEMINFO,
+    SOURCE_NET_DEV,
+} Source;
+
+static guint64 legacy_sample(Source source, FILE *file) {
+    guint64 total = 0, idle = 0;
+
+    switch (source) {
+    case SOURCE_CPU:
+        legacy_read_cpu(file, &total, &idle);
+        return total + idle;
+    case SOURCE_MEMINFO:
+        return legacy_read_meminfo(file);
+    default:
+        return legacy_read_net_dev(file);
+    }
+}
+
+static guint64 current_sample(Source source, const gchar *data) {
+    switch (source) {
+    case SOURCE_CPU:
+        return current_read_cpu(data);
+    case SOURCE_MEMINFO:
+        return current_read_meminfo(data);
+    default:
+        return current_read_net_dev(data);
+    }
+}
+
+static volatile guint64 sink;
+
+// Archivo real: cada muestra abre (antes) o relee con pread (ahora)
+static void bench_live(const gchar *label, const gchar *path, Source source, guint iterations) {
+    ProcFile *proc_file = proc_file_open(path);
+    if (!proc_file) {
+        printf("%-24s %12s %12s\n", label, "-", "-");
+        return;
+    }
+
+    gint64 start = g_get_monotonic_time();
+    for (guint i = 0; i < iterations; i++) {
+        FILE *file = fopen(path, "r");
+        if (!file) break;
+        sink += legacy_sample(source, file);
+        fclose(file);
+    }
+    double before = (double)(g_get_monotonic_time() - start) / iterations;
+
+    start = g_get_monotonic_time();
+    for (guint i = 0; i < iterations; i++) {
+        sink += current_sample(source, proc_file_read(proc_file, NULL));
+    }
+    double after = (double)(g_get_monotonic_time() - start) / iterations;
+
+    proc_file_close(proc_file);
+    printf("%-24s %9.2f us %9.2f us\n", label, before, after);
+}
+
+// Texto en memoria: solo el parser, sin llamadas al kernel. Devuelve FALSE
+// si las dos implementaciones no leen lo mismo
+static gboolean bench_fixture(const gchar *label, const gchar *data, Source source, guint iterations) {
+    gsize length = strlen(data);
+    guint64 expected = 0, result = 0;
+
+    gint64 start = g_get_monotonic_time();
+    for (guint i = 0; i < iterations; i++) {
+        FILE *file = fmemopen((void *)data, length, "r");
+        expected = legacy_sample(source, file);
+        fclose(file);
+    }
+    double before = (double)(g_get_monotonic_time() - start) / iterations;
+
+    start = g_get_monotonic_time();
+    for (guint i = 0; i < iterations; i++) {
+        result = current_sample(source, data);
+    }
+    double after = (double)(g_get_monotonic_time() - start) / iterations;
+
+    sink += result;
+    printf("%-24s %9.2f us %9.2f us\n", label, before, after);
+
+    if (result != expected) {
+        fprintf(stderr, "%s: resultado distinto (%" G_GUINT64_FORMAT " frente a %" G_GUINT64_FORMAT ")\n",
+                label, result, expected);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static gchar *synthetic_net_dev(guint n_interfaces) {
+    GString *text = g_string_new(
+        "Inter-|   Receive                                                |  Transmit\n"
+        " face |bytes    packets errs drop fifo frame compressed multicast|"
+        "bytes    packets errs drop fifo colls carrier compressed\n");
+
+    for (guint i = 0; i < n_interfaces; i++) {
+        guint64 rx = (guint64)(i + 1) * 1048573;
+        guint64 tx = (guint64)(i + 1) * 524287;
+
+        g_string_append_printf(text,
+            "veth%05u: %10" G_GUINT64_FORMAT " %7u    0    0    0     0          0         0 "
+            "%10" G_GUINT64_FORMAT " %7u    0    0    0     0       0          0\n",
+            i, rx, i * 7, tx, i * 5);
+    }
+
+    return g_string_free(text, FALSE);
+}
+
+// --- Volcados de rtnetlink, como los trocea el kernel pero en un solo bloque ---
+
+static void append_padded(GByteArray *dump, const void *data, gsize size, gsize aligned) {
+    static const guint8 padding[NLMSG_ALIGNTO];
+
+    g_byte_array_append(dump, data, size);
+    g_byte_array_append(dump, padding, aligned - size);
+}
+
+static gsize begin_message(GByteArray *dump, guint16 type, const void *header, gsize size) {
+    struct nlmsghdr nlh = { .nlmsg_type = type, .nlmsg_flags = NLM_F_MULTI, .nlmsg_seq = 1 };
+    gsize offset = dump->len;
+
+    g_byte_array_append(dump, (const guint8 *)&nlh, sizeof(nlh));
+    append_padded(dump, header, size, NLMSG_ALIGN(size));
+    return offset;
+}
+
+static void end_message(GByteArray *dump, gsize offset) {
+    struct nlmsghdr *nlh = (struct nlmsghdr *)(dump->data + offset);
+    nlh->nlmsg_len = dump->len - offset;
+}
+
+static void append_attr(GByteArray *dump, guint16 type, const void *data, gsize size) {
+    struct rtattr rta = { .rta_len = RTA_LENGTH(size), .rta_type = type };
+
+    g_byte_array_append(dump, (const guint8 *)&rta, sizeof(rta));
+    append_padded(dump, data, size, RTA_ALIGN(size));
+}
+
+static void append_done(GByteArray *dump) {
+    gint32 status = 0;
+    end_message(dump, begin_message(dump, NLMSG_DONE, &status, sizeof(status)));
+}
+
+// Los mismos contadores que synthetic_net_dev
+static struct rtnl_link_stats64 synthetic_counters(guint i) {
+    struct rtnl_link_stats64 counters = {
+        .rx_bytes = (guint64)(i + 1) * 1048573,
+        .tx_bytes = (guint64)(i + 1) * 524287,
+        .rx_packets = i * 7,
+        .tx_packets = i * 5,
+    };
+    return counters;
+}
+
+// Respuesta a RTM_GETLINK: además del nombre y los contadores, los atributos
+// más comunes que manda el kernel y que el parser tiene que saltar
+static GByteArray *synthetic_getlink(guint n_interfaces) {
+    GByteArray *dump = g_byte_array_new();
+    static const guint8 address[6] = { 0x02, 0x42, 0xac, 0x11, 0x00, 0x02 };
+    static const guint8 broadcast[6] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+    guint32 mtu = 1500, txqlen = 1000;
+    guint8 operstate = 6; // IF_OPER_UP
+
+    for (guint i = 0; i < n_interfaces; i++) {
+        struct ifinfomsg ifi = { .ifi_family = AF_UNSPEC, .ifi_index = (int)i + 1,
+                                 .ifi_flags = IFF_UP | IFF_RUNNING };
+        struct rtnl_link_stats64 counters = synthetic_counters(i);
+        struct rtnl_link_stats counters32 = {
+            .rx_bytes = (guint32)counters.rx_bytes,
+            .tx_bytes = (guint32)counters.tx_bytes,
+        };
+        gchar name[IF_NAMESIZE];
+
+        g_snprintf(name, sizeof(name), "veth%05u", i);
+
+        gsize offset = begin_message(dump, RTM_NEWLINK, &ifi, sizeof(ifi));
+        append_attr(dump, IFLA_IFNAME, name, strlen(name) + 1);
+        append_attr(dump, IFLA_TXQLEN, &txqlen, sizeof(txqlen));
+        append_attr(dump, IFLA_OPERSTATE, &operstate, sizeof(operstate));
+        append_attr(dump, IFLA_MTU, &mtu, sizeof(mtu));
+        append_attr(dump, IFLA_QDISC, "noqueue", sizeof("noqueue"));
+        append_attr(dump, IFLA_ADDRESS, address, sizeof(address));
+        append_attr(dump, IFLA_BROADCAST, broadcast, sizeof(broadcast));
+        append_attr(dump, IFLA_STATS64, &counters, sizeof(counters));
+        append_attr(dump, IFLA_STATS, &counters32, sizeof(counters32));
+        end_message(dump, offset);
+    }
+
+    append_done(dump);
+    return dump;
+}
+
+// Respuesta a RTM_GETSTATS filtrado a IFLA_STATS_LINK_64
+static GByteArray *synthetic_getstats(guint n_interfaces) {
+    GByteArray *dump = g_byte_array_new();
+
+    for (guint i = 0; i < n_interfaces; i++) {
+        struct if_stats_msg ifsm = { .family = AF_UNSPEC, .ifindex = i + 1,
+                                     .filter_mask = IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64) };
+        struct rtnl_link_stats64 counters = synthetic_counters(i);
+
+        gsize offset = begin_message(dump, RTM_NEWSTATS, &ifsm, sizeof(ifsm));
+        append_attr(dump, IFLA_STATS_LINK_64, &counters, sizeof(counters));
+        end_message(dump, offset);
+    }
+
+    append_done(dump);
+    return dump;
+}
+
+static void on_netlink_done(gboolean success G_GNUC_UNUSED, gpointer user_data G_GNUC_UNUSED) {
+}
+
+// Un volcado por el mismo camino que el watch del socket; -1 si no suma lo
+// mismo que el /proc/net/dev equivalente
+static double time_netlink_dump(NetlinkStats *stats, guint64 *total, const GByteArray *dump,
+                                guint64 expected, guint iterations) {
+    gint64 start = g_get_monotonic_time();
+    for (guint i = 0; i < iterations; i++) {
+        *total = 0;
+        netlink_stats_parse_reply(stats, dump->data, dump->len);
+    }
+    double elapsed = (double)(g_get_monotonic_time() - start) / iterations;
+
+    sink += *total;
+    return *total == expected ? elapsed : -1;
+}
+
+// net/dev frente a RTM_NEWLINK (primera petición) y RTM_NEWSTATS (las
+// siguientes, con la caché de nombres ya llena por la primera)
+static gboolean bench_netlink(guint n_interfaces, guint iterations) {
+    gchar *fixture = synthetic_net_dev(n_interfaces);
+    GByteArray *getlink = synthetic_getlink(n_interfaces);
+    GByteArray *getstats = synthetic_getstats(n_interfaces);
+    gchar *label = g_strdup_printf("%u interfaces", n_interfaces);
+    gboolean ok = TRUE;
+
+    gint64 start = g_get_monotonic_time();
+    guint64 expected = 0;
+    for (guint i = 0; i < iterations; i++) {
+        expected = current_read_net_dev(fixture);
+    }
+    double net_dev = (double)(g_get_monotonic_time() - start) / iterations;
+    sink += expected;
+
+    // El watch del socket queda en un contexto que nunca se itera
+    GMainContext *context = g_main_context_new();
+    guint64 total = 0;
+    NetlinkStats *stats = netlink_stats_new(context, add_counters, on_netlink_done, &total);
+
+    if (stats) {
+        double newlink = time_netlink_dump(stats, &total, getlink, expected, iterations);
+        double newstats = time_netlink_dump(stats, &total, getstats, expected, iterations);
+
+        printf("%-24s %9.2f us %9.2f us %9.2f us\n", label, net_dev, newlink, newstats);
+
+        if (newlink < 0 || newstats < 0) {
+            fprintf(stderr, "%s: los volcados netlink no suman lo mismo que net/dev\n", label);
+            ok = FALSE;
+        }
+        netlink_stats_free(stats);
+    } else {
+        printf("%-24s %9.2f us %12s %12s\n", label, net_dev, "-", "-");
+    }
+
+    g_main_context_unref(context);
+    g_free(label);
+    g_byte_array_unref(getstats);
+    g_byte_array_unref(getlink);
+    g_free(fixture);
+    return ok;
+}
+
+static const gchar stat_fixture[] =
+    "cpu  1445932 1021 780412 36250011 23154 0 14210 632551 0 0\n"
+    "cpu0 361483 255 195103 9062502 5788 0 3552 158137 0 0\n"
+    "cpu1 361483 255 195103 9062502 5788 0 3552 158137 0 0\n"
+    "cpu2 361483 255 195103 9062502 5788 0 3552 158137 0 0\n"
+    "cpu3 361483 256 195103 9062505 5790 0 3554 158140 0 0\n"
+    "intr 295289 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 1 1 2 0 0\n"
+    "ctxt 1534363\n"
+    "btime 1792194984\n"
+    "processes 4012\n"
+    "procs_running 1\n"
+    "procs_blocked 0\n";
+
+static const gchar meminfo_fixture[] =
+    "MemTotal:        6158152 kB\n"
+    "MemFree:         4786460 kB\n"
+    "MemAvailable:    5637360 kB\n"
+    "Buffers:          385056 kB\n"
+    "Cached:           623688 kB\n"
+    "SwapCached:            0 kB\n"
+    "Active:           618700 kB\n"
+    "Inactive:         549572 kB\n"
+    "Active(anon):         20 kB\n"
+    "Inactive(anon):   168688 kB\n"
+    "Active(file):     618680 kB\n"
+    "Inactive(file):   380884 kB\n"
+    "Unevictable:        9544 kB\n"
+    "Mlocked:            9544 kB\n"
+    "SwapTotal:       2097148 kB\n"
+    "SwapFree:        2097148 kB\n"
+    "Zswap:                 0 kB\n"
+    "Zswapped:              0 kB\n"
+    "Dirty:               160 kB\n"
+    "Writeback:             0 kB\n"
+    "AnonPages:        169136 kB\n"
+    "Mapped:           141572 kB\n"
+    "Shmem:              9176 kB\n"
+    "KReclaimable:     119032 kB\n"
+    "Slab:             144564 kB\n"
+    "SReclaimable:     119032 kB\n"
+    "SUnreclaim:        25532 kB\n"
+    "KernelStack:        3968 kB\n"
+    "PageTables:         4624 kB\n"
+    "CommitLimit:     5176224 kB\n"
+    "Committed_AS:    1170116 kB\n"
+    "VmallocTotal:   34359738367 kB\n"
+    "VmallocUsed:       14772 kB\n"
+    "HugePages_Total:       0\n"
+    "Hugepagesize:       2048 kB\n";
+
+int main(int argc, char **argv) {
+    guint iterations = argc > 1 ? (guint)MAX(atoi(argv[1]), 1) : DEFAULT_ITERATIONS;
+    gboolean ok = TRUE;
+
+    printf("%u iteraciones por caso\n", iterations);
+    printf("%-24s %12s %12s\n", "", "antes", "ahora");
+
+    bench_live("/proc/stat", "/proc/stat", SOURCE_CPU, iterations);
+    bench_live("/proc/meminfo", "/proc/meminfo", SOURCE_MEMINFO, iterations);
+    bench_live("/proc/net/dev", "/proc/net/dev", SOURCE_NET_DEV, iterations);
+
+    ok &= bench_fixture("stat en memoria", stat_fixture, SOURCE_CPU, iterations);
+    ok &= bench_fixture("meminfo en memoria", meminfo_fixture, SOURCE_MEMINFO, iterations);
+
+    static const guint sizes[] = { 10, 100, 1000 };
+    for (guint i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        gchar *fixture = synthetic_net_dev(sizes[i]);
+        gchar *label = g_strdup_printf("net/dev en memoria, %u", sizes[i]);
+        guint count = MAX(iterations / sizes[i] * 10, 1);
+
+        ok &= bench_fixture(label, fixture, SOURCE_NET_DEV, count);
+
+        g_free(label);
+        g_free(fixture);
+    }
+
+    printf("\n%-24s %12s %12s %12s\n", "rtnetlink en memoria", "net/dev", "NEWLINK", "NEWSTATS");
+    for (guint i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        ok &= bench_netlink(sizes[i], MAX(iterations / sizes[i] * 10, 1));
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
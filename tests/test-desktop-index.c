@@ -0,0 +1,210 @@
+// Índice binario de aplicaciones: lo que se construye se vuelve a leer igual,
+// y un archivo truncado, de otro formato o con desplazamientos fuera de la
+// tabla de cadenas se rechaza en lugar de leerse fuera del mmap.
+
+#include <gio/gio.h>
+#include <string.h>
+#include "desktop_index.h"
+
+// Cabecera del formato (desktop_index.c): magic, versión, entorno, n_dirs,
+// n_entries y tamaño de la tabla de cadenas; detrás van IndexDir de 16 bytes
+// e IndexEntry de 8 campos de 32 bits
+#define HEADER_VERSION 1
+#define HEADER_N_DIRS 3
+#define HEADER_STRINGS_SIZE 5
+#define HEADER_SIZE (6 * sizeof(guint32))
+#define DIR_SIZE 16
+
+static const gchar browser_desktop[] =
+    "[Desktop Entry]\n"
+    "Type=Application\n"
+    "Name=Test Browser\n"
+    "Icon=test-browser\n"
+    "Exec=sh -c true\n"
+    "Categories=Network;WebBrowser;\n"
+    "StartupWMClass=TestBrowser\n";
+
+static const gchar hidden_desktop[] =
+    "[Desktop Entry]\n"
+    "Type=Application\n"
+    "Name=Test Helper\n"
+    "Exec=sh -c true\n"
+    "NoDisplay=true\n";
+
+static void write_desktop_file(const gchar *name, const gchar *contents) {
+    gchar *dir = g_build_filename(g_get_user_data_dir(), "applications", NULL);
+    gchar *path = g_build_filename(dir, name, NULL);
+
+    g_assert_cmpint(g_mkdir_with_parents(dir, 0700), ==, 0);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+
+    g_free(path);
+    g_free(dir);
+}
+
+static void on_rebuilt(GObject *source G_GNUC_UNUSED, GAsyncResult *result, gpointer user_data) {
+    DesktopIndex **index = user_data;
+    GError *error = NULL;
+
+    *index = desktop_index_rebuild_finish(result, NULL, &error);
+    g_assert_no_error(error);
+}
+
+// Construir el índice de los .desktop de prueba; queda escrito en la caché
+static DesktopIndex *build_index(void) {
+    DesktopIndex *index = NULL;
+
+    write_desktop_file("test-browser.desktop", browser_desktop);
+    write_desktop_file("test-helper.desktop", hidden_desktop);
+
+    desktop_index_rebuild_async(NULL, NULL, on_rebuilt, &index);
+    while (!index) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+
+    return index;
+}
+
+static gchar *index_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "simple-panel", "desktop-index", NULL);
+}
+
+static gboolean find_entry(DesktopIndex *index, const gchar *id, DesktopIndexEntry *entry) {
+    for (guint i = 0; i < desktop_index_get_n_entries(index); i++) {
+        desktop_index_get_entry(index, i, entry);
+        if (strcmp(entry->id, id) == 0) return TRUE;
+    }
+    return FALSE;
+}
+
+static void test_round_trip(void) {
+    DesktopIndex *built = build_index();
+    gboolean stale;
+    DesktopIndexEntry entry;
+
+    DesktopIndex *loaded = desktop_index_load(&stale);
+    g_assert_nonnull(loaded);
+    g_assert_false(stale);
+    g_assert_cmpuint(desktop_index_get_n_entries(loaded), ==, desktop_index_get_n_entries(built));
+    g_assert_cmpuint(desktop_index_get_n_entries(loaded), ==, 2);
+
+    g_assert_true(find_entry(loaded, "test-browser.desktop", &entry));
+    g_assert_cmpstr(entry.name, ==, "Test Browser");
+    g_assert_cmpstr(entry.icon, ==, "test-browser");
+    g_assert_cmpstr(entry.categories, ==, "Network;WebBrowser;");
+    g_assert_cmpstr(entry.exec, ==, "sh -c true");
+    g_assert_cmpstr(entry.wm_class, ==, "TestBrowser");
+    g_assert_true(g_str_has_suffix(entry.filename, "/applications/test-browser.desktop"));
+    g_assert_true(entry.show);
+
+    // Las NoDisplay también se guardan, sin ningún campo opcional
+    g_assert_true(find_entry(loaded, "test-helper.desktop", &entry));
+    g_assert_cmpstr(entry.icon, ==, "");
+    g_assert_cmpstr(entry.categories, ==, "");
+    g_assert_cmpstr(entry.wm_class, ==, "");
+    g_assert_false(entry.show);
+
+    desktop_index_unref(loaded);
+    desktop_index_unref(built);
+
+    // Un .desktop nuevo cambia el mtime de su directorio
+    write_desktop_file("test-other.desktop", hidden_desktop);
+    loaded = desktop_index_load(&stale);
+    g_assert_nonnull(loaded);
+    g_assert_true(stale);
+    desktop_index_unref(loaded);
+}
+
+typedef void (*CorruptFunc)(GByteArray *contents);
+
+// Construir un índice válido, estropearlo en disco y comprobar que no se carga
+static void assert_rejected(CorruptFunc corrupt) {
+    desktop_index_unref(build_index());
+
+    gchar *path = index_path();
+    gchar *data;
+    gsize size;
+    gboolean stale = FALSE;
+
+    g_assert_true(g_file_get_contents(path, &data, &size, NULL));
+    GByteArray *contents = g_byte_array_new_take((guint8 *)data, size);
+
+    corrupt(contents);
+    g_assert_true(g_file_set_contents(path, (const gchar *)contents->data, contents->len, NULL));
+
+    g_assert_null(desktop_index_load(&stale));
+    g_assert_true(stale);
+
+    g_byte_array_unref(contents);
+    g_free(path);
+}
+
+static guint32 *header_field(GByteArray *contents, guint field) {
+    return (guint32 *)contents->data + field;
+}
+
+static void truncate_strings(GByteArray *contents) {
+    g_byte_array_set_size(contents, contents->len - 1);
+}
+
+static void truncate_header(GByteArray *contents) {
+    g_byte_array_set_size(contents, HEADER_SIZE / 2);
+}
+
+static void break_magic(GByteArray *contents) {
+    contents->data[0] = 'X';
+}
+
+static void change_version(GByteArray *contents) {
+    *header_field(contents, HEADER_VERSION) += 1;
+}
+
+// El id de la primera entrada apunta justo detrás de la tabla de cadenas
+static void offset_out_of_range(GByteArray *contents) {
+    guint32 n_dirs = *header_field(contents, HEADER_N_DIRS);
+    guint32 strings_size = *header_field(contents, HEADER_STRINGS_SIZE);
+    guint32 *first_entry = (guint32 *)(contents->data + HEADER_SIZE + n_dirs * DIR_SIZE);
+
+    first_entry[0] = strings_size;
+}
+
+// Sin el NUL final, la última cadena seguiría leyendo fuera del archivo
+static void drop_last_nul(GByteArray *contents) {
+    contents->data[contents->len - 1] = 'x';
+}
+
+static void test_truncated(void) {
+    assert_rejected(truncate_strings);
+    assert_rejected(truncate_header);
+}
+
+static void test_bad_magic(void) {
+    assert_rejected(break_magic);
+}
+
+static void test_other_version(void) {
+    assert_rejected(change_version);
+}
+
+static void test_offset_out_of_range(void) {
+    assert_rejected(offset_out_of_range);
+}
+
+static void test_missing_nul(void) {
+    assert_rejected(drop_last_nul);
+}
+
+int main(int argc, char **argv) {
+    // Cada prueba con sus propios XDG_DATA_HOME, XDG_DATA_DIRS y XDG_CACHE_HOME
+    g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+    g_setenv("XDG_CURRENT_DESKTOP", "simple-panel-test", TRUE);
+
+    g_test_add_func("/desktop-index/round-trip", test_round_trip);
+    g_test_add_func("/desktop-index/truncated", test_truncated);
+    g_test_add_func("/desktop-index/bad-magic", test_bad_magic);
+    g_test_add_func("/desktop-index/other-version", test_other_version);
+    g_test_add_func("/desktop-index/offset-out-of-range", test_offset_out_of_range);
+    g_test_add_func("/desktop-index/missing-nul", test_missing_nul);
+
+    return g_test_run();
+}
@@ -0,0 +1,141 @@
+// Relevo de muestras entre el hilo de muestreo y el principal: con los dos
+// hilos publicando y recogiendo a la vez, ninguna muestra se pierde ni se
+// libera dos veces, y las recogidas van siempre hacia delante.
+
+#include <glib.h>
+#include <string.h>
+#include "snapshot_slot.h"
+
+#define N_SNAPSHOTS 200000
+#define N_SOURCES 8
+
+typedef struct {
+    guint id;
+} TestSnapshot;
+
+static SnapshotSlot slot;
+static gint freed[N_SNAPSHOTS];     // veces que se ha liberado cada muestra
+static gint producer_done;
+
+static TestSnapshot *test_snapshot_new(guint id) {
+    TestSnapshot *snapshot = g_new(TestSnapshot, 1);
+    snapshot->id = id;
+    return snapshot;
+}
+
+static void test_snapshot_free(gpointer data) {
+    TestSnapshot *snapshot = data;
+
+    g_atomic_int_inc(&freed[snapshot->id]);
+    g_free(snapshot);
+}
+
+static void reset(void) {
+    memset(freed, 0, sizeof(freed));
+    producer_done = 0;
+    snapshot_slot_init(&slot, test_snapshot_free);
+}
+
+static void assert_freed_once(guint count) {
+    for (guint i = 0; i < count; i++) {
+        g_assert_cmpint(freed[i], ==, 1);
+    }
+}
+
+// Sin consumidor, cada publicación libera la anterior y clear la última
+static void test_replace(void) {
+    guint sources;
+
+    reset();
+
+    snapshot_slot_publish(&slot, test_snapshot_new(0), 1u << 0);
+    snapshot_slot_publish(&slot, test_snapshot_new(1), 1u << 1);
+    g_assert_cmpint(freed[0], ==, 1);
+    g_assert_cmpint(freed[1], ==, 0);
+
+    TestSnapshot *snapshot = snapshot_slot_take(&slot, &sources);
+    g_assert_nonnull(snapshot);
+    g_assert_cmpuint(snapshot->id, ==, 1);
+    g_assert_cmpuint(sources, ==, (1u << 0) | (1u << 1));
+    test_snapshot_free(snapshot);
+
+    g_assert_null(snapshot_slot_take(&slot, &sources));
+    g_assert_cmpuint(sources, ==, 0);
+
+    snapshot_slot_publish(&slot, test_snapshot_new(2), 1u << 2);
+    snapshot_slot_clear(&slot);
+    assert_freed_once(3);
+}
+
+static gpointer producer_thread(gpointer user_data G_GNUC_UNUSED) {
+    for (guint i = 0; i < N_SNAPSHOTS; i++) {
+        snapshot_slot_publish(&slot, test_snapshot_new(i), 1u << (i % N_SOURCES));
+
+        // Ceder de vez en cuando para que los hilos se intercalen aunque
+        // solo haya un núcleo
+        if (i % 16 == 0) {
+            g_thread_yield();
+        }
+    }
+
+    g_atomic_int_set(&producer_done, 1);
+    return NULL;
+}
+
+static void test_threads(void) {
+    TestSnapshot *current = NULL;
+    guint sources_seen = 0;
+    guint taken = 0;
+
+    reset();
+
+    GThread *producer = g_thread_new("snapshot-producer", producer_thread, NULL);
+
+    for (;;) {
+        // Leído antes de recoger: si ya había terminado, esta recogida ve
+        // todo lo publicado
+        gboolean done = g_atomic_int_get(&producer_done);
+        guint sources;
+        TestSnapshot *snapshot = snapshot_slot_take(&slot, &sources);
+
+        if (snapshot) {
+            g_assert_true(current == NULL || snapshot->id > current->id);
+            if (current) {
+                test_snapshot_free(current);
+            }
+            current = snapshot;
+            taken++;
+        }
+
+        // Una máscara nunca llega antes que la muestra que la cubre
+        if (sources) {
+            g_assert_nonnull(current);
+        }
+        sources_seen |= sources;
+
+        if (done) break;
+        g_thread_yield();
+    }
+
+    g_thread_join(producer);
+
+    // La última publicación siempre llega al consumidor
+    g_assert_nonnull(current);
+    g_assert_cmpuint(current->id, ==, N_SNAPSHOTS - 1);
+    g_assert_cmpuint(sources_seen, ==, (1u << N_SOURCES) - 1);
+    test_snapshot_free(current);
+
+    snapshot_slot_clear(&slot);
+    assert_freed_once(N_SNAPSHOTS);
+
+    g_test_message("%u de %u muestras recogidas", taken, N_SNAPSHOTS);
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/snapshot-slot/replace", test_replace);
+    g_test_add_func("/snapshot-slot/threads", test_threads);
+
+    return g_test_run();
+}
@@ -0,0 +1,96 @@
+// El panel sigue respondiendo con un /proc lento: las lecturas van en el hilo
+// de muestreo, así que un temporizador del hilo principal se sigue
+// despachando a tiempo aunque cada muestra tarde cientos de ms.
+
+#include <glib.h>
+#include "system_monitor.h"
+
+// Cada lectura tarda SLOW_READ_MS; el bucle principal mide los huecos entre
+// despachos de un temporizador de TIMER_MS durante RUN_MS
+#define SLOW_READ_MS 300
+#define SAMPLE_INTERVAL_MS 250
+#define TIMER_MS 10
+#define RUN_MS 2000
+
+// Muy por debajo de una lectura: si alguna se hiciera en el hilo principal,
+// el hueco superaría SLOW_READ_MS
+#define MAX_GAP_MS 100
+
+typedef struct {
+    GMainLoop *loop;
+    gint reads;             // lo escribe el hilo de muestreo
+    guint updates;
+    gint64 last_dispatch;
+    gint64 max_gap;
+} ResponsivenessTest;
+
+static void slow_read(guint sources G_GNUC_UNUSED, gpointer user_data) {
+    ResponsivenessTest *test = user_data;
+
+    g_usleep(SLOW_READ_MS * 1000);
+    g_atomic_int_inc(&test->reads);
+}
+
+static void on_updated(SystemMonitor *monitor G_GNUC_UNUSED, guint sources, gpointer user_data) {
+    ResponsivenessTest *test = user_data;
+
+    if (sources & SYSTEM_MONITOR_CPU) test->updates++;
+}
+
+static gboolean on_timer(gpointer user_data) {
+    ResponsivenessTest *test = user_data;
+    gint64 now = g_get_monotonic_time();
+
+    if (test->last_dispatch > 0) {
+        test->max_gap = MAX(test->max_gap, now - test->last_dispatch);
+    }
+    test->last_dispatch = now;
+
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_run_finished(gpointer user_data) {
+    ResponsivenessTest *test = user_data;
+
+    g_main_loop_quit(test->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static void test_slow_read_responsive(void) {
+    SystemMonitor *monitor = system_monitor_get_default();
+    ResponsivenessTest test = { .loop = g_main_loop_new(NULL, FALSE) };
+
+    system_monitor_set_read_hook(monitor, slow_read, &test);
+    gulong handler = g_signal_connect(monitor, "updated", G_CALLBACK(on_updated), &test);
+    system_monitor_subscribe(monitor, SYSTEM_MONITOR_CPU, SAMPLE_INTERVAL_MS);
+    // Sin suscriptores visibles el intervalo se alargaría a segundos
+    system_monitor_set_visible(monitor, SYSTEM_MONITOR_CPU, TRUE);
+
+    guint timer_id = g_timeout_add(TIMER_MS, on_timer, &test);
+    g_timeout_add(RUN_MS, on_run_finished, &test);
+    g_main_loop_run(test.loop);
+
+    g_source_remove(timer_id);
+    system_monitor_set_visible(monitor, SYSTEM_MONITOR_CPU, FALSE);
+    system_monitor_unsubscribe(monitor, SYSTEM_MONITOR_CPU);
+    g_signal_handler_disconnect(monitor, handler);
+    system_monitor_set_read_hook(monitor, NULL, NULL);
+
+    g_test_message("%d lecturas lentas, %u emisiones, hueco máximo %.1f ms",
+                   g_atomic_int_get(&test.reads), test.updates, test.max_gap / 1000.0);
+
+    // Las muestras siguen llegando, solo que más despacio
+    g_assert_cmpint(g_atomic_int_get(&test.reads), >=, 3);
+    g_assert_cmpuint(test.updates, >=, 3);
+    g_assert_cmpint(test.max_gap, <, MAX_GAP_MS * 1000);
+
+    g_main_loop_unref(test.loop);
+}
+
+int main(int argc, char **argv) {
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/system-monitor/slow-read-responsive", test_slow_read_responsive);
+
+    return g_test_run();
+}